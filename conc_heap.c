@@ -0,0 +1,210 @@
+// Concurrent priority queue built from sharded Heaps
+// -----------------------------------------------
+// - k shards, each a plain Heap behind its own mutex on its own cache line
+// - Insert: lock a random shard (trylock a few, then block) and push
+// - Relaxed extract (MultiQueue): look at two random shards, pop the
+//   better top; queues scale because threads rarely meet on one lock
+// - Strict extract: lock all shards in index order and pop the global best
+//
+// Shard sizes are mirrored in atomics so extractors skip empty shards
+// without taking their locks. Tops are only ever compared under both
+// shard locks: items may be freed by their owner as soon as another
+// thread pops them, so reading them unlocked would be a use-after-free.
+//
+// -----------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "conc_heap.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define CONC_HEAP_DEFAULT_SHARDS 16
+#define CONC_HEAP_CACHE_LINE     64
+#define CONC_HEAP_TRIES          8
+
+typedef struct Shard {
+    _Alignas(CONC_HEAP_CACHE_LINE) pthread_mutex_t lock;
+    Heap *heap;
+    atomic_size_t size;   // mirror of heap_size(heap), read without the lock
+} Shard;
+
+struct ConcHeap {
+    Shard *shards;
+    size_t nshards;
+    heap_cmp_fn cmp;
+    ConcHeapMode mode;
+};
+
+// --- Per-thread random shard choice (xorshift64*) ---
+
+static _Thread_local uint64_t rng_state;
+static atomic_uint_fast64_t rng_seed = UINT64_C(0x9E3779B97F4A7C15);
+
+static inline uint64_t rng_next(void) {
+    if (rng_state == 0)
+        rng_state = atomic_fetch_add(&rng_seed, UINT64_C(0x9E3779B97F4A7C15)) | 1;
+    uint64_t x = rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng_state = x;
+    return x * UINT64_C(0x2545F4914F6CDD1D);
+}
+
+static inline size_t pick(const ConcHeap *q) {
+    return (size_t)(rng_next() % q->nshards);
+}
+
+// --- Shard helpers (caller holds s->lock) ---
+
+static inline void publish_size(Shard *s) {
+    atomic_store_explicit(&s->size, heap_size(s->heap), memory_order_relaxed);
+}
+
+static inline bool looks_empty(const Shard *s) {
+    return atomic_load_explicit(&s->size, memory_order_relaxed) == 0;
+}
+
+static void *pop_locked(Shard *s) {
+    void *item = heap_extract(s->heap);
+    publish_size(s);
+    return item;
+}
+
+// Lock some shard, preferring uncontended ones.
+static Shard *lock_any(ConcHeap *q) {
+    for (int t = 0; t < CONC_HEAP_TRIES; t++) {
+        Shard *s = &q->shards[pick(q)];
+        if (pthread_mutex_trylock(&s->lock) == 0)
+            return s;
+    }
+    Shard *s = &q->shards[pick(q)];
+    pthread_mutex_lock(&s->lock);
+    return s;
+}
+
+// -----------------------------------------------------------
+// Public API
+// -----------------------------------------------------------
+
+ConcHeap *conc_heap_create(heap_cmp_fn cmp, size_t shards, ConcHeapMode mode) {
+    if (!cmp) return NULL;
+    if (shards == 0) shards = CONC_HEAP_DEFAULT_SHARDS;
+
+    ConcHeap *q = calloc(1, sizeof(*q));
+    if (!q) return NULL;
+    q->shards = aligned_alloc(CONC_HEAP_CACHE_LINE, shards * sizeof(Shard));
+    if (!q->shards) { free(q); return NULL; }
+
+    for (size_t i = 0; i < shards; i++) {
+        Shard *s = &q->shards[i];
+        s->heap = heap_create(cmp, 0);
+        if (!s->heap || pthread_mutex_init(&s->lock, NULL) != 0) {
+            heap_destroy(s->heap);
+            q->nshards = i;
+            conc_heap_destroy(q);
+            return NULL;
+        }
+        atomic_init(&s->size, 0);
+    }
+    q->nshards = shards;
+    q->cmp = cmp;
+    q->mode = mode;
+    return q;
+}
+
+void conc_heap_destroy(ConcHeap *q) {
+    if (!q) return;
+    for (size_t i = 0; i < q->nshards; i++) {
+        pthread_mutex_destroy(&q->shards[i].lock);
+        heap_destroy(q->shards[i].heap);
+    }
+    free(q->shards);
+    free(q);
+}
+
+int conc_heap_insert(ConcHeap *q, void *item) {
+    Shard *s = lock_any(q);
+    int rc = heap_insert(s->heap, item);
+    publish_size(s);
+    pthread_mutex_unlock(&s->lock);
+    return rc;
+}
+
+// Two-choice pop: lock two random non-empty shards (trylock only, so
+// holding one lock never blocks on another) and take the better top.
+static void *extract_relaxed(ConcHeap *q) {
+    for (int t = 0; t < CONC_HEAP_TRIES; t++) {
+        Shard *a = &q->shards[pick(q)], *b = &q->shards[pick(q)];
+        if (looks_empty(a)) a = b;
+        if (looks_empty(b)) b = a;
+        if (looks_empty(a))
+            continue;
+        if (a > b) { Shard *tmp = a; a = b; b = tmp; }
+
+        if (pthread_mutex_trylock(&a->lock) != 0)
+            continue;
+        if (b != a && pthread_mutex_trylock(&b->lock) != 0) {
+            pthread_mutex_unlock(&a->lock);
+            continue;
+        }
+        Shard *best = a;
+        void *ta = heap_peek(a->heap), *tb = heap_peek(b->heap);
+        if (!ta || (tb && q->cmp(tb, ta) > 0))
+            best = b;
+        void *item = heap_size(best->heap) ? pop_locked(best) : NULL;
+        if (b != a) pthread_mutex_unlock(&b->lock);
+        pthread_mutex_unlock(&a->lock);
+        if (item)
+            return item;
+    }
+
+    // Contended or nearly empty: sweep every shard so NULL really means
+    // the queue was empty when each shard was visited.
+    size_t start = pick(q);
+    for (size_t k = 0; k < q->nshards; k++) {
+        Shard *s = &q->shards[(start + k) % q->nshards];
+        if (looks_empty(s))
+            continue;
+        pthread_mutex_lock(&s->lock);
+        void *item = pop_locked(s);
+        pthread_mutex_unlock(&s->lock);
+        if (item)
+            return item;
+    }
+    return NULL;
+}
+
+// Global best under all locks (taken in index order, so strict
+// extractors cannot deadlock; inserters only ever hold one lock).
+static void *extract_strict(ConcHeap *q) {
+    Shard *best = NULL;
+    for (size_t i = 0; i < q->nshards; i++) {
+        Shard *s = &q->shards[i];
+        pthread_mutex_lock(&s->lock);
+        void *top = heap_peek(s->heap);
+        if (top && (!best || q->cmp(top, heap_peek(best->heap)) > 0))
+            best = s;
+    }
+    void *item = best ? pop_locked(best) : NULL;
+    for (size_t i = q->nshards; i-- > 0;)
+        pthread_mutex_unlock(&q->shards[i].lock);
+    return item;
+}
+
+void *conc_heap_extract(ConcHeap *q) {
+    if (!q) return NULL;
+    return q->mode == CONC_HEAP_STRICT ? extract_strict(q) : extract_relaxed(q);
+}
+
+size_t conc_heap_size(const ConcHeap *q) {
+    if (!q) return 0;
+    size_t n = 0;
+    for (size_t i = 0; i < q->nshards; i++)
+        n += atomic_load_explicit(&q->shards[i].size, memory_order_relaxed);
+    return n;
+}
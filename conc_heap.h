@@ -0,0 +1,69 @@
+#ifndef CONC_HEAP_H
+#define CONC_HEAP_H
+
+#include <stddef.h> // size_t
+#include "heap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Ordering guarantee of a concurrent heap.
+ *
+ * CONC_HEAP_RELAXED (MultiQueue): extract compares the tops of two random
+ * shards and pops the better one. Throughput scales with the shard count;
+ * the popped item is near the global best but not necessarily the best.
+ *
+ * CONC_HEAP_STRICT: extract locks every shard in order and pops the global
+ * best, exactly like a single locked Heap. Inserts still spread over
+ * shards, but extract is O(shards) and serializes consumers.
+ */
+typedef enum ConcHeapMode {
+    CONC_HEAP_RELAXED = 0,
+    CONC_HEAP_STRICT = 1
+} ConcHeapMode;
+
+typedef struct ConcHeap ConcHeap;
+
+/**
+ * @brief Create a thread-safe priority queue made of per-shard Heaps.
+ *
+ * Each shard is a Heap behind its own mutex on its own cache line. A good
+ * shard count for the relaxed mode is 2-4x the number of threads.
+ *
+ * @param cmp Comparator function. Must return positive if a > b.
+ * @param shards Number of shards (0 for default).
+ * @param mode CONC_HEAP_RELAXED or CONC_HEAP_STRICT.
+ * @return Pointer to ConcHeap or NULL on failure.
+ */
+ConcHeap *conc_heap_create(heap_cmp_fn cmp, size_t shards, ConcHeapMode mode);
+
+/**
+ * @brief Free the queue. No other thread may be using it.
+ */
+void conc_heap_destroy(ConcHeap *q);
+
+/**
+ * @brief Insert an item into a random shard (thread-safe).
+ * @return 0 on success, HEAP_ERR_NOMEM on allocation failure.
+ */
+int conc_heap_insert(ConcHeap *q, void *item);
+
+/**
+ * @brief Remove and return a top item (thread-safe).
+ *
+ * See ConcHeapMode for which item is returned.
+ * @return The item, or NULL if every shard was empty.
+ */
+void *conc_heap_extract(ConcHeap *q);
+
+/**
+ * @brief Number of items (a snapshot while other threads are active).
+ */
+size_t conc_heap_size(const ConcHeap *q);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,471 @@
+// External-memory priority queue with spill-to-disk runs
+// -----------------------------------------------
+// - In-memory stage: a Heap of pointers into a fixed arena of elements,
+//   sized to half the memory budget
+// - Spill: when the arena is full, drain the Heap in order and write the
+//   elements best first as one sorted run (large sequential writes)
+// - Runs are read back one block at a time; a small Heap of runs ordered
+//   by their head element does the k-way merge
+// - Extract compares the in-memory root with the best run head
+// - Runs are levelled: a spill makes a level-0 run, and whenever the
+//   EXT_HEAP_FANIN newest runs share a level they are merged into one run
+//   a level up, like carries in a counter. Each element is rewritten
+//   O(log n) times and at most EXT_HEAP_MAX_RUNS runs are open, so read
+//   buffers stay within a quarter of the budget (a merge briefly adds
+//   one block per merged run)
+// - A merge writes a new run and retires its sources only on success,
+//   so a failed merge loses nothing
+//
+// Spill files are created with mkstemp() and unlinked immediately, so
+// they disappear when their descriptors close, even after a crash.
+//
+// -----------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ext_heap.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define EXT_HEAP_DEFAULT_BUDGET ((size_t)64 << 20)
+#define EXT_HEAP_MAX_RUNS       64
+#define EXT_HEAP_FANIN          8
+#define EXT_HEAP_MIN_BLOCK      4096
+#define EXT_HEAP_MIN_MEM        16
+
+// One sorted run on disk, best element first.
+typedef struct Run {
+    heap_cmp_fn cmp;      // user comparator (run_cmp has no context)
+    int fd;
+    off_t read_off;       // next byte to read
+    size_t remaining;     // elements not yet read into buf
+    unsigned char *buf;   // current block, plus one spare slot
+    size_t count, pos;    // elements in buf, index of the head
+    size_t elem;
+    unsigned level;       // merges this run went through
+} Run;
+
+struct ExtHeap {
+    size_t elem;          // element size
+    heap_cmp_fn cmp;
+
+    // In-memory stage.
+    Heap *mem;            // pointers into arena
+    unsigned char *arena;
+    void **free_slots;    // unused arena slots (stack)
+    size_t nfree;
+    size_t mem_cap;       // arena slots
+    void **drain;         // scratch for spills, mem_cap entries
+
+    // Runs.
+    Heap *merge;          // Run * ordered by head element
+    Heap *group;          // scratch merge heap for run merges
+    Run *runs[EXT_HEAP_MAX_RUNS];  // oldest first, levels non-increasing
+    size_t nruns;
+    size_t disk_elems;    // elements held by runs
+    size_t block_elems;   // elements per read/write block
+    unsigned char *wbuf;  // write block
+    char *dir;
+};
+
+static inline const void *run_head(const Run *r) {
+    return r->buf + r->pos * r->elem;
+}
+
+static int run_cmp(const void *a, const void *b) {
+    const Run *x = a, *y = b;
+    return x->cmp(run_head(x), run_head(y));
+}
+
+// --- Run I/O ---
+
+static int write_all(int fd, const unsigned char *p, size_t n) {
+    while (n > 0) {
+        ssize_t w = write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += w;
+        n -= (size_t)w;
+    }
+    return 0;
+}
+
+// Read the next block of a run (r->remaining > 0).
+static int run_fill(Run *r, size_t block_elems) {
+    size_t n = r->remaining < block_elems ? r->remaining : block_elems;
+    size_t bytes = n * r->elem, got = 0;
+    while (got < bytes) {
+        ssize_t k = pread(r->fd, r->buf + got, bytes - got, r->read_off + (off_t)got);
+        if (k < 0 && errno == EINTR) continue;
+        if (k <= 0) {
+            if (k == 0) errno = EIO;
+            return -1;
+        }
+        got += (size_t)k;
+    }
+    r->read_off += (off_t)bytes;
+    r->remaining -= n;
+    r->count = n;
+    r->pos = 0;
+    return 0;
+}
+
+// Drop the head of r. Returns 1 if r has a new head, 0 if it is used up,
+// EXT_HEAP_ERR_IO if the refill failed; r then still holds the old head.
+static int run_advance(Run *r, size_t block_elems) {
+    if (r->pos + 1 < r->count) {
+        r->pos++;
+        return 1;
+    }
+    if (r->remaining == 0)
+        return 0;
+    // The refill overwrites buf: park the head in the spare slot so a
+    // failed read leaves it where a retry finds it.
+    unsigned char *spare = r->buf + block_elems * r->elem;
+    if (run_head(r) != spare)
+        memcpy(spare, run_head(r), r->elem);
+    if (run_fill(r, block_elems) < 0) {
+        r->count = block_elems + 1;
+        r->pos = block_elems;
+        return EXT_HEAP_ERR_IO;
+    }
+    return 1;
+}
+
+static void run_free(Run *r) {
+    if (!r) return;
+    if (r->fd >= 0) close(r->fd);
+    free(r->buf);
+    free(r);
+}
+
+// Streams elements into a new spill file through q->wbuf.
+typedef struct RunWriter {
+    ExtHeap *q;
+    int fd;
+    size_t buffered;      // elements in q->wbuf
+    size_t total;
+} RunWriter;
+
+static int writer_open(ExtHeap *q, RunWriter *w) {
+    size_t len = strlen(q->dir) + sizeof("/heapspill.XXXXXX");
+    char *path = malloc(len);
+    if (!path) { errno = ENOMEM; return -1; }
+    snprintf(path, len, "%s/heapspill.XXXXXX", q->dir);
+    int fd = mkstemp(path);
+    if (fd >= 0) unlink(path);
+    free(path);
+    if (fd < 0) return -1;
+    *w = (RunWriter){ .q = q, .fd = fd };
+    return 0;
+}
+
+static int writer_put(RunWriter *w, const void *elem) {
+    ExtHeap *q = w->q;
+    memcpy(q->wbuf + w->buffered * q->elem, elem, q->elem);
+    w->total++;
+    if (++w->buffered < q->block_elems)
+        return 0;
+    w->buffered = 0;
+    return write_all(w->fd, q->wbuf, q->block_elems * q->elem);
+}
+
+// Flush and turn the file into a Run positioned at its first block.
+static Run *writer_finish(RunWriter *w) {
+    ExtHeap *q = w->q;
+    Run *r = NULL;
+    if (write_all(w->fd, q->wbuf, w->buffered * q->elem) < 0)
+        goto fail;
+    r = calloc(1, sizeof(*r));
+    if (!r) goto fail;
+    r->buf = malloc((q->block_elems + 1) * q->elem);
+    if (!r->buf) goto fail;
+    r->cmp = q->cmp;
+    r->fd = w->fd;
+    r->elem = q->elem;
+    r->remaining = w->total;
+    if (run_fill(r, q->block_elems) < 0) {
+        w->fd = -1;  // owned by r now
+        run_free(r);
+        return NULL;
+    }
+    return r;
+fail:
+    if (r) free(r->buf);
+    free(r);
+    close(w->fd);
+    return NULL;
+}
+
+// --- Runs bookkeeping ---
+
+// Remove r, keeping the others in creation order.
+static void forget_run(ExtHeap *q, Run *r) {
+    for (size_t i = 0; i < q->nruns; i++) {
+        if (q->runs[i] == r) {
+            memmove(&q->runs[i], &q->runs[i + 1],
+                    (q->nruns - i - 1) * sizeof(q->runs[0]));
+            q->nruns--;
+            break;
+        }
+    }
+    run_free(r);
+}
+
+// Consume the head of the best run (the merge heap's root). On error
+// nothing changes.
+static int advance_top(ExtHeap *q) {
+    Run *r = heap_peek(q->merge);
+    int rc = run_advance(r, q->block_elems);
+    if (rc < 0)
+        return rc;
+    q->disk_elems--;
+    if (rc == 0) {
+        (void)heap_extract(q->merge);
+        forget_run(q, r);
+    } else {
+        (void)heap_replace(q->merge, r);  // same run, new head: sift it down
+    }
+    return 0;
+}
+
+// Rebuild a merge heap from runs (the heaps hold void *, not Run *).
+static void load_runs(Heap *h, Run **runs, size_t n) {
+    void *items[EXT_HEAP_MAX_RUNS];
+    for (size_t i = 0; i < n; i++)
+        items[i] = runs[i];
+    heap_clear(h);
+    (void)heap_insert_many(h, items, n);  // capacity EXT_HEAP_MAX_RUNS
+}
+
+// Private cursor over r for a merge: same file and position, its own
+// copy of the buffered elements, so advancing it leaves r untouched.
+static Run *run_shadow(const Run *r, size_t block_elems) {
+    Run *s = malloc(sizeof(*s));
+    if (!s) return NULL;
+    *s = *r;
+    s->buf = malloc((block_elems + 1) * r->elem);
+    if (!s->buf) { free(s); return NULL; }
+    memcpy(s->buf, r->buf, r->count * r->elem);
+    return s;
+}
+
+static void shadow_free(Run *s) {
+    s->fd = -1;  // the source run owns it
+    run_free(s);
+}
+
+// K-way merge the k newest runs into one run a level up. The merge reads
+// through shadow cursors and the sources are swapped for the new run only
+// once it is complete, so on error the partial run is deleted and the
+// queue is exactly as before. Costs k extra read blocks while it runs.
+static int merge_newest(ExtHeap *q, size_t k) {
+    size_t first = q->nruns - k;
+    unsigned level = q->runs[first]->level + 1;
+    Run *src[EXT_HEAP_MAX_RUNS];
+    size_t n = 0;
+    int rc = 0;
+    for (; n < k; n++) {
+        if (!(src[n] = run_shadow(q->runs[first + n], q->block_elems))) {
+            rc = HEAP_ERR_NOMEM;
+            break;
+        }
+    }
+    RunWriter w;
+    if (rc == 0 && writer_open(q, &w) < 0)
+        rc = EXT_HEAP_ERR_IO;
+    if (rc < 0) {
+        while (n > 0) shadow_free(src[--n]);
+        return rc;
+    }
+
+    load_runs(q->group, src, k);
+    while (heap_size(q->group) > 0) {
+        Run *r = heap_peek(q->group);
+        if (writer_put(&w, run_head(r)) < 0) {
+            rc = EXT_HEAP_ERR_IO;
+            break;
+        }
+        int more = run_advance(r, q->block_elems);
+        if (more < 0) {
+            rc = more;
+            break;
+        }
+        if (more)
+            (void)heap_replace(q->group, r);
+        else
+            (void)heap_extract(q->group);
+    }
+    heap_clear(q->group);
+    for (size_t i = 0; i < k; i++)
+        shadow_free(src[i]);
+
+    Run *out = NULL;
+    if (rc < 0)
+        close(w.fd);  // unlinked already: the partial run is gone
+    else if (!(out = writer_finish(&w)))
+        rc = EXT_HEAP_ERR_IO;
+    if (rc < 0)
+        return rc;
+
+    for (size_t i = first; i < q->nruns; i++)
+        run_free(q->runs[i]);
+    out->level = level;
+    q->runs[first] = out;
+    q->nruns = first + 1;
+    load_runs(q->merge, q->runs, q->nruns);
+    return 0;
+}
+
+// Carry: merge the EXT_HEAP_FANIN newest runs while they share a level.
+// Levels never increase towards the newest run, so this leaves fewer
+// than EXT_HEAP_FANIN runs per level.
+static int cascade(ExtHeap *q) {
+    while (q->nruns >= EXT_HEAP_FANIN &&
+           q->runs[q->nruns - EXT_HEAP_FANIN]->level == q->runs[q->nruns - 1]->level) {
+        int rc = merge_newest(q, EXT_HEAP_FANIN);
+        if (rc < 0) return rc;
+    }
+    return 0;
+}
+
+static void reset_arena(ExtHeap *q) {
+    for (size_t i = 0; i < q->mem_cap; i++)
+        q->free_slots[i] = q->arena + (q->mem_cap - 1 - i) * q->elem;
+    q->nfree = q->mem_cap;
+}
+
+// Write the in-memory stage out as one run, best first. On failure the
+// drained elements go back into the Heap (its capacity is still there).
+static int spill(ExtHeap *q) {
+    if (q->nruns == EXT_HEAP_MAX_RUNS) {
+        // Every level is full (FANIN^9 spills deep): fold all runs into one.
+        int rc = merge_newest(q, q->nruns);
+        if (rc < 0) return rc;
+    }
+    size_t n = heap_drain_sorted(q->mem, q->drain);  // ascending
+    RunWriter w;
+    Run *r = NULL;
+    if (writer_open(q, &w) == 0) {
+        size_t i = n;
+        while (i > 0 && writer_put(&w, q->drain[i - 1]) == 0)
+            i--;
+        if (i == 0)
+            r = writer_finish(&w);
+        else
+            close(w.fd);
+    }
+    if (!r) {
+        (void)heap_insert_many(q->mem, q->drain, n);
+        return EXT_HEAP_ERR_IO;
+    }
+    q->runs[q->nruns++] = r;
+    q->disk_elems += n;
+    (void)heap_insert(q->merge, r);
+    reset_arena(q);
+    return cascade(q);
+}
+
+// -----------------------------------------------------------
+// Public API
+// -----------------------------------------------------------
+
+ExtHeap *ext_heap_create(size_t elem_size, heap_cmp_fn cmp, size_t mem_budget,
+                         const char *tmp_dir) {
+    if (elem_size == 0 || !cmp) return NULL;
+    if (mem_budget == 0) mem_budget = EXT_HEAP_DEFAULT_BUDGET;
+    if (!tmp_dir) tmp_dir = getenv("TMPDIR");
+    if (!tmp_dir || !*tmp_dir) tmp_dir = "/tmp";
+
+    ExtHeap *q = calloc(1, sizeof(*q));
+    if (!q) return NULL;
+    q->elem = elem_size;
+    q->cmp = cmp;
+
+    // Half the budget for the in-memory stage, a quarter for run blocks.
+    size_t block = mem_budget / (4 * EXT_HEAP_MAX_RUNS);
+    if (block < EXT_HEAP_MIN_BLOCK) block = EXT_HEAP_MIN_BLOCK;
+    q->block_elems = block / elem_size ? block / elem_size : 1;
+    q->mem_cap = (mem_budget / 2) / (elem_size + 3 * sizeof(void *));
+    if (q->mem_cap < EXT_HEAP_MIN_MEM) q->mem_cap = EXT_HEAP_MIN_MEM;
+
+    q->dir = malloc(strlen(tmp_dir) + 1);
+    q->arena = malloc(q->mem_cap * elem_size);
+    q->free_slots = malloc(q->mem_cap * sizeof(void *));
+    q->drain = malloc(q->mem_cap * sizeof(void *));
+    q->wbuf = malloc(q->block_elems * elem_size);
+    q->mem = heap_create(cmp, q->mem_cap);
+    q->merge = heap_create(run_cmp, EXT_HEAP_MAX_RUNS);
+    q->group = heap_create(run_cmp, EXT_HEAP_MAX_RUNS);
+    if (!q->dir || !q->arena || !q->free_slots || !q->drain || !q->wbuf ||
+        !q->mem || !q->merge || !q->group) {
+        ext_heap_destroy(q);
+        return NULL;
+    }
+    strcpy(q->dir, tmp_dir);
+    reset_arena(q);
+    return q;
+}
+
+void ext_heap_destroy(ExtHeap *q) {
+    if (!q) return;
+    for (size_t i = 0; i < q->nruns; i++)
+        run_free(q->runs[i]);
+    heap_destroy(q->group);
+    heap_destroy(q->merge);
+    heap_destroy(q->mem);
+    free(q->wbuf);
+    free(q->drain);
+    free(q->free_slots);
+    free(q->arena);
+    free(q->dir);
+    free(q);
+}
+
+int ext_heap_insert(ExtHeap *q, const void *elem) {
+    if (q->nfree == 0) {
+        int rc = spill(q);
+        if (rc < 0)
+            return rc;
+    }
+    void *slot = q->free_slots[--q->nfree];
+    memcpy(slot, elem, q->elem);
+    (void)heap_insert(q->mem, slot);  // capacity reserved for mem_cap items
+    return 0;
+}
+
+const void *ext_heap_peek(const ExtHeap *q) {
+    if (!q) return NULL;
+    const void *m = heap_peek(q->mem);
+    const Run *r = heap_peek(q->merge);
+    if (!r) return m;
+    if (!m || q->cmp(run_head(r), m) > 0) return run_head(r);
+    return m;
+}
+
+int ext_heap_extract(ExtHeap *q, void *out) {
+    if (!q) return 0;
+    const void *top = ext_heap_peek(q);
+    if (!top) return 0;
+    if (out) memcpy(out, top, q->elem);
+    if (top == heap_peek(q->mem)) {
+        q->free_slots[q->nfree++] = heap_extract(q->mem);
+        return 1;
+    }
+    return advance_top(q) < 0 ? EXT_HEAP_ERR_IO : 1;
+}
+
+size_t ext_heap_size(const ExtHeap *q) {
+    return q ? heap_size(q->mem) + q->disk_elems : 0;
+}
+
+size_t ext_heap_runs(const ExtHeap *q) {
+    return q ? q->nruns : 0;
+}
@@ -0,0 +1,79 @@
+#ifndef EXT_HEAP_H
+#define EXT_HEAP_H
+
+#include <stddef.h> // size_t
+#include "heap.h"   // heap_cmp_fn, error codes
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** A read or write of a spill file failed (errno is set). */
+#define EXT_HEAP_ERR_IO (-3)
+
+typedef struct ExtHeap ExtHeap;
+
+/**
+ * @brief Create an external-memory priority queue of by-value elements.
+ *
+ * Inserts go into an in-memory Heap. When it reaches its share of the
+ * memory budget it is drained in order into a sorted run on disk, written
+ * sequentially. Extract takes the best of the in-memory root and the run
+ * heads, which are kept in a small merge heap and refilled with large
+ * sequential reads. Runs are merged eight at a time, newest first and only
+ * with runs of the same level, so each element is rewritten O(log n)
+ * times and at most 64 runs are open at once. Spill files are unlinked at
+ * creation and vanish with the queue.
+ *
+ * @param elem_size Size of one element in bytes (> 0).
+ * @param cmp Comparator over element pointers. Must return positive if a > b.
+ * @param mem_budget Approximate bytes of RAM to use (0 for 64 MiB).
+ * @param tmp_dir Directory for spill files (NULL for $TMPDIR or /tmp).
+ * @return Pointer to ExtHeap or NULL on failure.
+ */
+ExtHeap *ext_heap_create(size_t elem_size, heap_cmp_fn cmp, size_t mem_budget,
+                         const char *tmp_dir);
+
+/**
+ * @brief Free the queue and delete its spill files.
+ */
+void ext_heap_destroy(ExtHeap *q);
+
+/**
+ * @brief Insert a copy of the element at `elem`.
+ * @return 0 on success, HEAP_ERR_NOMEM, or EXT_HEAP_ERR_IO if a spill
+ *         failed (the element is not inserted then). A failed spill or
+ *         run merge keeps every element already in the queue.
+ */
+int ext_heap_insert(ExtHeap *q, const void *elem);
+
+/**
+ * @brief Pointer to the top element, or NULL if empty.
+ *
+ * Valid until the next modification of the queue.
+ */
+const void *ext_heap_peek(const ExtHeap *q);
+
+/**
+ * @brief Copy the top element into out (may be NULL) and remove it.
+ * @return 1 if an element was removed, 0 if the queue is empty,
+ *         EXT_HEAP_ERR_IO if refilling a run failed. The queue is then
+ *         unchanged (out may already hold the top) and the call can be
+ *         retried.
+ */
+int ext_heap_extract(ExtHeap *q, void *out);
+
+/**
+ * @brief Number of elements, in memory and on disk.
+ */
+size_t ext_heap_size(const ExtHeap *q);
+
+/**
+ * @brief Number of sorted runs currently on disk.
+ */
+size_t ext_heap_runs(const ExtHeap *q);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
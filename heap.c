@@ -2,6 +2,7 @@
 // -----------------------------------------------
 // - Fully generic: stores void* elements
 // - Custom comparator for min- or max-heap behavior
+// - Binary by default; 4-ary and 8-ary layouts via heap_create_ex
 // - Supports build, insert, extract, replace, clone, validation, and sort
 // - Designed for correctness, clarity, and extensibility
 //
@@ -10,67 +11,609 @@
 //
 // -----------------------------------------------
 
+#define _POSIX_C_SOURCE 200809L  // pthreads, sysconf
+
 #include "heap.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <assert.h>
+#include <stdint.h>     // uintptr_t
 #include <sys/types.h>  // for ssize_t
+#include <pthread.h>
+#include <unistd.h>     // sysconf
 
 #define HEAP_DEFAULT_CAP 16
+#define HEAP_CACHE_LINE  64
+#define HEAP_DATA_ALIGN  (2 * HEAP_CACHE_LINE)  // one blocked-layout block
 
 // Core heap structure - opaque to users.
 struct Heap {
-    void **data;          // dynamic array of pointers
+    void **data;          // dynamic array of pointers (inside `block`)
+    void *block;          // raw allocation; data[1] starts a cache line
     size_t size;          // current number of elements
     size_t capacity;      // allocated capacity
     heap_cmp_fn cmp;      // user-provided comparison function
+    size_t arity;         // children per node (2, 4 or 8)
+    unsigned shift;       // log2(arity)
+    bool blocked;         // HEAP_LAYOUT_BLOCKED index mapping
+    size_t bound;         // fixed capacity of a bounded heap (0 = growable)
+    bool lazy;            // inserts append unordered until the next read
+    size_t pending;       // unordered tail data[size - pending .. size)
+    size_t pending_top;   // slot of the tail's best element (pending > 0)
+
+    // Growth policy, see heap_set_growth_policy().
+    double grow_factor;   // capacity multiplier when full
+    size_t max_grow_step; // most slots added per growth (0 = unlimited)
+    size_t min_capacity;  // floor for growth and automatic shrinking
+    double shrink_below;  // auto-shrink fill ratio (0 = off)
+    size_t shrink_at;     // size below which to shrink (cached, 0 = off)
+    HeapAllocator mem;    // where every byte of this heap comes from
+    bool borrowed;        // header and data are caller storage (heap_init_static)
+
+    // Insertion order, allocated for HeapConfig.stable.
+    uint32_t *seq;        // sequence number of each slot
+    size_t seq_cap;       // entries in seq (>= capacity)
+    uint32_t next_seq;    // sequence of the next element to enter
+
+    // Position index, allocated on the first heap_insert_handle().
+    size_t *slot_handle;  // handle owning each slot
+    size_t slot_cap;      // entries in slot_handle (>= capacity)
+    size_t *handle_pos;   // slot of each live handle, or HANDLE_FREE|next
+    size_t handle_cap;    // entries in handle_pos
+    size_t free_handle;   // head of the free handle list (HANDLE_NONE = empty)
+#ifdef HEAP_STATS
+    HeapStats stats;      // see heap_get_stats()
+#endif
 };
 
+// --- Instrumentation (HEAP_STATS) ---
+// STAT(...) and STAT_DECL(...) compile to nothing unless HEAP_STATS is
+// defined, so the default build's sift loops are exactly the
+// uninstrumented ones.
+
+#ifdef HEAP_STATS
+#define STAT(stmt) do { stmt; } while (0)
+#define STAT_DECL(decl) decl
+
+static inline void stat_sift(Heap *h, uint64_t *passes, size_t levels) {
+    (*passes)++;
+    if (levels >= HEAP_STATS_DEPTH_BUCKETS) levels = HEAP_STATS_DEPTH_BUCKETS - 1;
+    h->stats.depth_hist[levels]++;
+}
+
+static inline void stat_size(Heap *h) {
+    if (h->size > h->stats.high_water) h->stats.high_water = h->size;
+}
+#else
+#define STAT(stmt) ((void)0)
+#define STAT_DECL(decl)
+#endif
+
+// Free handles are chained through handle_pos with the top bit set, so a
+// stale handle is recognisable in O(1).
+#define HANDLE_FREE ((size_t)1 << (sizeof(size_t) * 8 - 1))
+#define HANDLE_NONE (~HANDLE_FREE)
+
+// --- Blocked layout ---
+// Slot 0 is the root. Every other slot belongs to a block of BLOCK_NODES
+// consecutive slots holding the first 16 nodes, breadth-first, of two
+// sibling subtrees, interleaved pairwise: local slots 0,1 are the sibling
+// roots, 2k+2 and 2k+3 the children of local slot k. That is three full
+// levels (local 0..13) plus the children of local 6 (local 14, 15). The
+// children of the 9 leaves (local 7..15) of block b are the root pairs of
+// blocks 9b+1 .. 9b+9.
+// data[1] is 128-byte aligned (align_data()), so each 128-byte block is
+// exactly one aligned pair of lines, the unit the adjacent-line
+// prefetcher fetches together, and a sift moves at least BLOCK_LEVELS levels within
+// them before it jumps, instead of missing on every level. Siblings stay
+// adjacent and every parent precedes its children, so the array still
+// fills in slot order and the sift code below works unchanged.
+// Child blocks of deep blocks are far apart, so past the first few
+// levels every jump also lands on a new page (see HEAP_LAYOUT_BLOCKED).
+
+#define BLOCK_LEVELS 3
+#define BLOCK_NODES  16   // 2 * (2^BLOCK_LEVELS - 1) + 2, 128 bytes
+#define BLOCK_INNER  7    // local slots with children inside the block
+#define BLOCK_FANOUT 9    // child blocks per block
+
+static inline size_t blocked_parent(size_t i) {
+    size_t b = (i - 1) / BLOCK_NODES, k = (i - 1) % BLOCK_NODES;
+    if (k >= 2)
+        return 1 + b * BLOCK_NODES + ((k + 2) >> 1) - 2;
+    if (b == 0)
+        return 0;
+    size_t pb = (b - 1) / BLOCK_FANOUT, leaf = (b - 1) % BLOCK_FANOUT;
+    return 1 + pb * BLOCK_NODES + BLOCK_INNER + leaf;
+}
+
+static inline size_t blocked_child(size_t i) {
+    if (i == 0)
+        return 1;
+    size_t b = (i - 1) / BLOCK_NODES, k = (i - 1) % BLOCK_NODES;
+    if (k < BLOCK_INNER)
+        return 1 + b * BLOCK_NODES + 2 * k + 2;
+    return 1 + (b * BLOCK_FANOUT + 1 + (k - BLOCK_INNER)) * BLOCK_NODES;
+}
+
 // --- Utility index helpers ---
-// Parent/left/right are derived from binary tree layout in an array.
-static inline size_t parent(size_t i) { return (i - 1) / 2; }
-static inline size_t left(size_t i)   { return 2 * i + 1; }
-static inline size_t right(size_t i)  { return 2 * i + 2; }
+// Parent/first child are derived from d-ary tree layout in an array:
+// children of i are arity*i + 1 .. arity*i + arity (or the blocked
+// mapping above; children are contiguous either way).
+static inline size_t parent(const Heap *h, size_t i) {
+    return h->blocked ? blocked_parent(i) : (i - 1) >> h->shift;
+}
+static inline size_t child(const Heap *h, size_t i) {
+    return h->blocked ? blocked_child(i) : (i << h->shift) + 1;
+}
+
+// Swap two array slots, keeping the position index in sync.
+static inline void swap(Heap *h, size_t i, size_t j) {
+    void *tmp = h->data[i];
+    h->data[i] = h->data[j];
+    h->data[j] = tmp;
+    if (h->slot_handle) {
+        size_t hi = h->slot_handle[j], hj = h->slot_handle[i];
+        h->slot_handle[i] = hi;
+        h->slot_handle[j] = hj;
+        h->handle_pos[hi] = i;
+        h->handle_pos[hj] = j;
+    }
+    if (h->seq) {
+        uint32_t s = h->seq[i];
+        h->seq[i] = h->seq[j];
+        h->seq[j] = s;
+    }
+}
+
+// Move slot `src` into slot `dst` (src becomes garbage).
+static inline void move_slot(Heap *h, size_t dst, size_t src) {
+    h->data[dst] = h->data[src];
+    if (h->slot_handle) {
+        h->slot_handle[dst] = h->slot_handle[src];
+        h->handle_pos[h->slot_handle[dst]] = dst;
+    }
+    if (h->seq) h->seq[dst] = h->seq[src];
+}
+
+// Does slot i belong above slot j? Stable heaps settle comparator ties
+// by insertion order, earliest first; the sequence is only read then.
+static inline bool above(const Heap *h, size_t i, size_t j) {
+    int c = h->cmp(h->data[i], h->data[j]);
+    return c > 0 || (c == 0 && h->seq && h->seq[i] < h->seq[j]);
+}
+
+// --- Allocator helpers ---
+// All heap memory goes through h->mem. The default allocator forwards to
+// malloc/realloc/free; realloc_fn may be NULL (alloc + copy + free).
+
+static void *std_alloc(void *ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void *std_realloc(void *ctx, void *ptr, size_t old_size, size_t new_size) {
+    (void)ctx; (void)old_size;
+    return realloc(ptr, new_size);
+}
+
+static void std_free(void *ctx, void *ptr, size_t size) {
+    (void)ctx; (void)size;
+    free(ptr);
+}
+
+static const HeapAllocator std_allocator = {
+    .alloc_fn = std_alloc, .realloc_fn = std_realloc, .free_fn = std_free, .ctx = NULL
+};
+
+// Static heaps must never allocate: anything that would (handles, a large
+// top-k frontier, ...) fails cleanly instead.
+static void *null_alloc(void *ctx, size_t size) {
+    (void)ctx; (void)size;
+    return NULL;
+}
+
+static const HeapAllocator null_allocator = {
+    .alloc_fn = null_alloc, .realloc_fn = NULL, .free_fn = std_free, .ctx = NULL
+};
 
-// Swap two array slots.
-static inline void swap(void **a, void **b) {
-    void *tmp = *a;
-    *a = *b;
-    *b = tmp;
+static inline void *mem_alloc(const HeapAllocator *a, size_t size) {
+    return a->alloc_fn(a->ctx, size);
+}
+
+static inline void mem_free(const HeapAllocator *a, void *ptr, size_t size) {
+    if (ptr) a->free_fn(a->ctx, ptr, size);
+}
+
+static void *mem_realloc(const HeapAllocator *a, void *ptr, size_t old_size, size_t new_size) {
+    if (a->realloc_fn)
+        return a->realloc_fn(a->ctx, ptr, old_size, new_size);
+    void *p = mem_alloc(a, new_size);
+    if (!p) return NULL;
+    memcpy(p, ptr, old_size < new_size ? old_size : new_size);
+    mem_free(a, ptr, old_size);
+    return p;
+}
+
+// --- Storage helpers ---
+
+// Place `data` inside a raw block so that data[1], the first child of
+// the root, starts a 128-byte boundary. Every sibling group arity*i+1..
+// then begins on an arity-slot boundary, so for arity <= 8 all children
+// of a node share one 64-byte line, and every blocked-layout block is an
+// aligned pair of lines.
+static inline void **align_data(void *block) {
+    uintptr_t p = (uintptr_t)block + sizeof(void *);
+    p = (p + HEAP_DATA_ALIGN - 1) & ~(uintptr_t)(HEAP_DATA_ALIGN - 1);
+    return (void **)(p - sizeof(void *));
+}
+
+static inline size_t block_bytes(size_t capacity) {
+    return capacity * sizeof(void *) + HEAP_DATA_ALIGN;
+}
+
+// Resize the backing block to hold `n` slots, keeping the alignment
+// invariant (realloc may hand back a block with a different offset).
+static int resize_data(Heap *h, size_t n) {
+    // Resize the position index first: a failed grow leaves everything
+    // untouched, and an oversized index after a failed data grow (or a
+    // failed shrink) is harmless.
+    if (h->slot_handle) {
+        size_t cap = n ? n : 1;
+        size_t *sh = mem_realloc(&h->mem, h->slot_handle,
+                                 h->slot_cap * sizeof(size_t), cap * sizeof(size_t));
+        if (sh) {
+            h->slot_handle = sh;
+            h->slot_cap = cap;
+        } else if (n > h->slot_cap) {
+            return -1;
+        }
+    }
+    if (h->seq) {
+        size_t cap = n ? n : 1;
+        uint32_t *sq = mem_realloc(&h->mem, h->seq,
+                                   h->seq_cap * sizeof(uint32_t), cap * sizeof(uint32_t));
+        if (sq) {
+            h->seq = sq;
+            h->seq_cap = cap;
+        } else if (n > h->seq_cap) {
+            return -1;
+        }
+    }
+
+    size_t old_off = (size_t)((char *)h->data - (char *)h->block);
+    void *tmp = mem_realloc(&h->mem, h->block, block_bytes(h->capacity), block_bytes(n));
+    if (!tmp) return -1;
+    void **data = align_data(tmp);
+    size_t new_off = (size_t)((char *)data - (char *)tmp);
+    if (new_off != old_off)
+        memmove(data, (char *)tmp + old_off, h->size * sizeof(void *));
+    h->block = tmp;
+    h->data = data;
+    h->capacity = n;
+    h->shrink_at = h->shrink_below > 0 ? (size_t)((double)n * h->shrink_below) : 0;
+    STAT(h->stats.reallocs++; h->stats.bytes_reserved = block_bytes(n));
+    return 0;
+}
+
+// Capacity to grow to when at least `need` slots are required.
+static size_t grow_capacity(const Heap *h, size_t need) {
+    size_t cap = (size_t)((double)h->capacity * h->grow_factor);
+    if (cap <= h->capacity) cap = h->capacity + 1;
+    if (h->max_grow_step && cap - h->capacity > h->max_grow_step)
+        cap = h->capacity + h->max_grow_step;
+    if (cap < need) cap = need;
+    if (cap < h->min_capacity) cap = h->min_capacity;
+    return cap;
+}
+
+// Automatic shrink after removals. The target keeps one growth step of
+// headroom above the current size, and the policy guarantees
+// shrink_below * grow_factor < 1, so the heap must lose a further
+// fraction of its elements before it shrinks again, and must refill to
+// the new capacity before it grows: no realloc ping-pong around a level.
+static void maybe_shrink(Heap *h) {
+    if (h->size >= h->shrink_at || h->capacity <= h->min_capacity || h->bound)
+        return;
+    size_t target = (size_t)((double)h->size * h->grow_factor) + 1;
+    if (target < h->min_capacity) target = h->min_capacity;
+    if (target < h->capacity)
+        resize_data(h, target);  // failure just keeps the larger block
+}
+
+// --- Handle helpers ---
+
+// Chain handles [from, to) onto the free list.
+static void free_handle_range(Heap *h, size_t from, size_t to) {
+    for (size_t k = to; k-- > from;) {
+        h->handle_pos[k] = HANDLE_FREE | h->free_handle;
+        h->free_handle = k;
+    }
+}
+
+// Allocate the position index and give every current element a handle.
+static int enable_handles(Heap *h) {
+    size_t cap = h->capacity ? h->capacity : 1;
+    h->slot_handle = mem_alloc(&h->mem, cap * sizeof(size_t));
+    h->handle_pos = mem_alloc(&h->mem, cap * sizeof(size_t));
+    if (!h->slot_handle || !h->handle_pos) {
+        mem_free(&h->mem, h->slot_handle, cap * sizeof(size_t));
+        mem_free(&h->mem, h->handle_pos, cap * sizeof(size_t));
+        h->slot_handle = h->handle_pos = NULL;
+        return -1;
+    }
+    h->slot_cap = cap;
+    for (size_t i = 0; i < h->size; i++)
+        h->slot_handle[i] = h->handle_pos[i] = i;
+    h->handle_cap = cap;
+    h->free_handle = HANDLE_NONE;
+    free_handle_range(h, h->size, cap);
+    return 0;
+}
+
+// Make room for `n` live handles. Every element owns exactly one
+// handle, so after this the next n - size attaches cannot fail.
+static int reserve_handles(Heap *h, size_t n) {
+    if (h->handle_cap >= n) return 0;
+    size_t cap = h->handle_cap * 2;
+    if (cap < n) cap = n;
+    size_t *tmp = mem_realloc(&h->mem, h->handle_pos,
+                              h->handle_cap * sizeof(size_t), cap * sizeof(size_t));
+    if (!tmp) return -1;
+    h->handle_pos = tmp;
+    free_handle_range(h, h->handle_cap, cap);
+    h->handle_cap = cap;
+    return 0;
+}
+
+// Bind a fresh handle to slot `i`.
+static int attach_handle(Heap *h, size_t i) {
+    if (h->free_handle == HANDLE_NONE && reserve_handles(h, h->handle_cap + 1) < 0)
+        return -1;
+    size_t id = h->free_handle;
+    h->free_handle = h->handle_pos[id] & ~HANDLE_FREE;
+    h->slot_handle[i] = id;
+    h->handle_pos[id] = i;
+    return 0;
+}
+
+// Return the handle bound to slot `i` to the free list.
+static inline void release_handle(Heap *h, size_t i) {
+    size_t id = h->slot_handle[i];
+    h->handle_pos[id] = HANDLE_FREE | h->free_handle;
+    h->free_handle = id;
+}
+
+// Slot of a live handle, or HANDLE_NONE for stale or unknown handles.
+static inline size_t handle_slot(const Heap *h, HeapHandle handle) {
+    if (!h->handle_pos || handle >= h->handle_cap) return HANDLE_NONE;
+    size_t pos = h->handle_pos[handle];
+    return (pos & HANDLE_FREE) ? HANDLE_NONE : pos;
+}
+
+// Allocate an empty heap with exactly `capacity` slots.
+static Heap *heap_new(heap_cmp_fn cmp, size_t capacity, size_t arity,
+                      const HeapAllocator *mem) {
+    unsigned shift = 0;
+    while (((size_t)1 << shift) < arity) shift++;
+    if (arity < 2 || arity > HEAP_MAX_ARITY || ((size_t)1 << shift) != arity)
+        return NULL;
+    if (!mem) mem = &std_allocator;
+    if (!mem->alloc_fn || !mem->free_fn) return NULL;
+
+    Heap *h = mem_alloc(mem, sizeof(*h));
+    if (!h) return NULL;
+    memset(h, 0, sizeof(*h));
+    h->mem = *mem;
+
+    h->block = mem_alloc(mem, block_bytes(capacity));
+    if (!h->block) { mem_free(mem, h, sizeof(*h)); return NULL; }
+
+    h->data = align_data(h->block);
+    h->capacity = capacity;
+    h->cmp = cmp;
+    h->arity = arity;
+    h->shift = shift;
+    h->grow_factor = 2.0;
+    h->min_capacity = HEAP_DEFAULT_CAP;
+    STAT(h->stats.bytes_reserved = block_bytes(capacity));
+    return h;
 }
 
 // --- Heapify helpers ---
 
 // Bubble element at index `i` up until heap property is restored.
-// Runs in O(log n).
-static void sift_up(Heap *h, size_t i) {
+// Runs in O(log n). Returns the final index.
+static size_t sift_up(Heap *h, size_t i) {
+    STAT_DECL(size_t levels = 0);
     while (i > 0) {
-        size_t p = parent(i);
-        if (h->cmp(h->data[i], h->data[p]) <= 0)
+        size_t p = parent(h, i);
+        STAT(h->stats.compares++);
+        if (!above(h, i, p))
             break;
-        swap(&h->data[i], &h->data[p]);
+        swap(h, i, p);
+        STAT(h->stats.swaps++; levels++);
         i = p;
     }
+    STAT(stat_sift(h, &h->stats.sift_ups, levels));
+    return i;
 }
 
-// Push element at index `i` down until heap property holds.
-// Also O(log n).
-static void sift_down(Heap *h, size_t i) {
+// Push element at index `i` down until heap property holds among the
+// first n slots. O(arity * log_arity n).
+static void sift_down_within(Heap *h, size_t i, size_t n) {
+    STAT_DECL(size_t levels = 0);
     for (;;) {
-        size_t l = left(i), r = right(i), largest = i;
+        size_t c = child(h, i), largest = i;
+        size_t end = c + h->arity;
+        if (end > n) end = n;
+        STAT(if (c < end) h->stats.compares += end - c);
 
-        // Choose the larger child (for max-heap)
-        if (l < h->size && h->cmp(h->data[l], h->data[largest]) > 0)
-            largest = l;
-        if (r < h->size && h->cmp(h->data[r], h->data[largest]) > 0)
-            largest = r;
+        // Choose the largest child (for max-heap)
+        for (; c < end; c++)
+            if (above(h, c, largest))
+                largest = c;
 
         if (largest == i)
             break;  // property restored
-        swap(&h->data[i], &h->data[largest]);
+        swap(h, i, largest);
+        STAT(h->stats.swaps++; levels++);
         i = largest;
     }
+    STAT(stat_sift(h, &h->stats.sift_downs, levels));
+}
+
+static inline void sift_down(Heap *h, size_t i) {
+    sift_down_within(h, i, h->size);
+}
+
+// Bottom-up (Wegener) sift for an element placed at the root from the
+// bottom of the heap, as in extract, replace and sort. Such an element
+// nearly always belongs near the leaves again, so instead of comparing
+// it at every level, walk the path of largest children down to a leaf
+// (arity - 1 comparisons per level, children move up into the hole) and
+// then bubble the element up from there, which is usually a step or two.
+// Roughly halves comparisons against sift_down for binary heaps.
+static void sift_down_bottomup(Heap *h, size_t i) {
+    void *x = h->data[i];
+    size_t xh = h->slot_handle ? h->slot_handle[i] : 0;
+    uint32_t xs = h->seq ? h->seq[i] : 0;
+    STAT_DECL(size_t levels = 0);
+    for (;;) {
+        size_t c = child(h, i);
+        if (c >= h->size)
+            break;
+        size_t end = c + h->arity, best = c;
+        if (end > h->size) end = h->size;
+        STAT(h->stats.compares += end - c - 1);
+        for (c++; c < end; c++)
+            if (above(h, c, best))
+                best = c;
+        move_slot(h, i, best);
+        STAT(h->stats.swaps++; levels++);
+        i = best;
+    }
+    STAT(stat_sift(h, &h->stats.sift_downs, levels));
+    h->data[i] = x;
+    if (h->slot_handle) {
+        h->slot_handle[i] = xh;
+        h->handle_pos[xh] = i;
+    }
+    if (h->seq) h->seq[i] = xs;
+    sift_up(h, i);
+}
+
+// Bottom-up heapify — Floyd’s algorithm (O(n)) over the whole array.
+// In the blocked layout child() is not monotonic, so the last internal
+// node is not parent(size - 1); walk every slot (leaves exit at once).
+static void heapify(Heap *h) {
+    if (h->size < 2) return;
+    size_t start = h->blocked ? h->size - 1 : parent(h, h->size - 1);
+    for (ssize_t i = (ssize_t)start; i >= 0; i--)
+        sift_down(h, (size_t)i);
+}
+
+static inline unsigned floor_log2(size_t n) {
+    unsigned k = 0;
+    while (n >>= 1) k++;
+    return k;
+}
+
+// True if sifting `n` new tail elements up one by one could cost more
+// than one Floyd pass over all `total` (n * depth > 2 * total compares).
+static inline bool cheaper_to_heapify(const Heap *h, size_t n, size_t total) {
+    size_t depth = floor_log2(total) / h->shift;
+    return n * depth > 2 * total;
+}
+
+// Slot i was just appended to the lazy tail.
+static inline void note_pending(Heap *h, size_t i) {
+    if (h->pending == 0 || above(h, i, h->pending_top))
+        h->pending_top = i;
+    h->pending++;
+}
+
+// Slot of the best element, lazy tail included, without writing. Ties
+// go to the ordered root.
+static inline size_t top_slot(const Heap *h) {
+    if (h->pending == 0) return 0;
+    if (h->pending == h->size || above(h, h->pending_top, 0))
+        return h->pending_top;
+    return 0;
+}
+
+// Slot i's item changed priority while a lazy tail may be pending. Make
+// the state flush() relies on true again: a tail slot only affects which
+// tail element is best; a prefix slot is sifted within the ordered
+// prefix, whose parents and children never reach into the tail.
+static void settle(Heap *h, size_t i) {
+    size_t ordered = h->size - h->pending;
+    if (i >= ordered) {
+        h->pending_top = ordered;
+        for (size_t j = ordered + 1; j < h->size; j++)
+            if (above(h, j, h->pending_top))
+                h->pending_top = j;
+    } else if (sift_up(h, i) == i) {
+        sift_down_within(h, i, ordered);
+    }
+}
+
+// Order the lazily appended tail into the heap. Everything that changes
+// heap order calls this first; it is a no-op on non-lazy heaps. The
+// tail's best goes to the root first (a larger root keeps the prefix in
+// order), so what heap_peek() reported is what extract returns.
+static void flush(Heap *h) {
+    if (h->pending == 0) return;
+    size_t top = top_slot(h);
+    if (top != 0)
+        swap(h, 0, top);
+    if (cheaper_to_heapify(h, h->pending, h->size)) {
+        heapify(h);
+    } else {
+        for (size_t i = h->size - h->pending; i < h->size; i++)
+            sift_up(h, i);
+    }
+    h->pending = 0;
+}
+
+// --- Insertion sequence (stable heaps) ---
+
+#define SEQ_MAX UINT32_MAX  // stamps are 0 .. SEQ_MAX - 1
+
+// The sequence is about to run out: renumber the live elements 0 ..
+// size - 1 in priority order, so equal elements keep their relative
+// order and new stamps continue from size. Heapsort in place leaves the
+// slots ascending; reversed they are descending, which is heap order in
+// every layout because parents sit at lower indices than their children.
+// O(n log n) once per ~4 billion inserts, no allocation.
+static void renumber(Heap *h) {
+    flush(h);
+    size_t n = h->size;
+    while (h->size > 1) {
+        swap(h, 0, h->size - 1);
+        h->size--;
+        sift_down_bottomup(h, 0);
+    }
+    h->size = n;
+    for (size_t i = 0, j = n; i + 1 < j; i++, j--)
+        swap(h, i, j - 1);
+    for (size_t i = 0; i < n; i++)
+        h->seq[i] = (uint32_t)i;
+    h->next_seq = (uint32_t)n;
+}
+
+// Make room for n more stamps. Fails only when a stable heap would hold
+// more than SEQ_MAX elements.
+static inline int reserve_seq(Heap *h, size_t n) {
+    if (!h->seq || SEQ_MAX - h->next_seq >= n) return 0;
+    if (h->size > SEQ_MAX || SEQ_MAX - h->size < n) return HEAP_ERR_FULL;
+    renumber(h);
+    return 0;
+}
+
+// Stamp slot i as the newest element (after reserve_seq).
+static inline void stamp(Heap *h, size_t i) {
+    if (h->seq) h->seq[i] = h->next_seq++;
 }
 
 // -----------------------------------------------------------
@@ -79,17 +622,64 @@ static void sift_down(Heap *h, size_t i) {
 
 // Create an empty heap with optional initial capacity.
 Heap *heap_create(heap_cmp_fn cmp, size_t capacity) {
+    return heap_create_ex(cmp, capacity, NULL);
+}
+
+// Create an empty heap with explicit configuration (NULL = defaults).
+Heap *heap_create_ex(heap_cmp_fn cmp, size_t capacity, const HeapConfig *cfg) {
     if (!cmp) return NULL;
     if (capacity == 0) capacity = HEAP_DEFAULT_CAP;
+    size_t arity = (cfg && cfg->arity) ? cfg->arity : 2;
+    if (cfg && cfg->layout == HEAP_LAYOUT_BLOCKED && arity != 2) return NULL;
+    Heap *h = heap_new(cmp, capacity, arity, cfg ? cfg->allocator : NULL);
+    if (h && cfg) {
+        h->lazy = cfg->lazy_insert;
+        h->blocked = cfg->layout == HEAP_LAYOUT_BLOCKED;
+        if (cfg->stable) {
+            h->seq = mem_alloc(&h->mem, capacity * sizeof(uint32_t));
+            if (!h->seq) { heap_destroy(h); return NULL; }
+            h->seq_cap = capacity;
+        }
+    }
+    return h;
+}
 
-    Heap *h = calloc(1, sizeof(*h));
-    if (!h) return NULL;
+// Create an empty heap whose memory all comes from `alloc`.
+Heap *heap_create_with_allocator(heap_cmp_fn cmp, size_t capacity,
+                                 const HeapAllocator *alloc) {
+    HeapConfig cfg = { .allocator = alloc };
+    return heap_create_ex(cmp, capacity, &cfg);
+}
 
-    h->data = malloc(capacity * sizeof(void *));
-    if (!h->data) { free(h); return NULL; }
+// Create a heap that never holds more than k elements.
+Heap *heap_create_bounded(heap_cmp_fn cmp, size_t k) {
+    if (!cmp || k == 0) return NULL;
+    Heap *h = heap_new(cmp, k, 2, NULL);
+    if (h) h->bound = k;
+    return h;
+}
 
-    h->capacity = capacity;
+_Static_assert(sizeof(struct Heap) <= sizeof(HeapStorage),
+               "HEAP_STORAGE_SIZE too small for struct Heap");
+_Static_assert(_Alignof(struct Heap) <= _Alignof(HeapStorage),
+               "HeapStorage under-aligned for struct Heap");
+
+// Set up a heap entirely inside caller-owned memory.
+Heap *heap_init_static(HeapStorage *storage, void **buf, size_t cap, heap_cmp_fn cmp) {
+    if (!storage || !buf || cap == 0 || !cmp) return NULL;
+    Heap *h = (Heap *)(void *)storage;
+    memset(h, 0, sizeof(*h));
+    h->data = buf;
+    h->block = buf;
+    h->capacity = h->bound = cap;
     h->cmp = cmp;
+    h->arity = 2;
+    h->shift = 1;
+    h->grow_factor = 2.0;
+    h->min_capacity = cap;
+    h->mem = null_allocator;
+    h->borrowed = true;
+    STAT(h->stats.bytes_reserved = cap * sizeof(void *));
     return h;
 }
 
@@ -97,87 +687,275 @@ Heap *heap_create(heap_cmp_fn cmp, size_t capacity) {
 Heap *heap_build(void **arr, size_t n, heap_cmp_fn cmp) {
     if (!cmp) return NULL;
 
-    Heap *h = calloc(1, sizeof(*h));
+    Heap *h = heap_new(cmp, n, 2, NULL);
     if (!h) return NULL;
-    h->data = malloc(n * sizeof(void *));
-    if (!h->data) { free(h); return NULL; }
-
-    memcpy(h->data, arr, n * sizeof(void *));
-    h->size = h->capacity = n;
-    h->cmp = cmp;
-
-    // Bottom-up heapify — Floyd’s algorithm (O(n))
-    for (ssize_t i = (ssize_t)(n / 2) - 1; i >= 0; i--)
-        sift_down(h, (size_t)i);
 
+    if (n > 0)
+        memcpy(h->data, arr, n * sizeof(void *));
+    h->size = n;
+    heapify(h);
+    STAT(stat_size(h));
     return h;
 }
 
 // Destroy heap and release memory.
 void heap_destroy(Heap *h) {
-    if (!h) return;
-    free(h->data);
-    free(h);
+    if (!h || h->borrowed) return;
+    HeapAllocator mem = h->mem;
+    mem_free(&mem, h->slot_handle, h->slot_cap * sizeof(size_t));
+    mem_free(&mem, h->handle_pos, h->handle_cap * sizeof(size_t));
+    mem_free(&mem, h->seq, h->seq_cap * sizeof(uint32_t));
+    mem_free(&mem, h->block, block_bytes(h->capacity));
+    mem_free(&mem, h, sizeof(*h));
 }
 
 // Ensure at least `n` capacity, preserving contents.
 int heap_reserve(Heap *h, size_t n) {
     if (h->capacity >= n) return 0;
-    void **tmp = realloc(h->data, n * sizeof(void *));
-    if (!tmp) return -1;
-    h->data = tmp;
-    h->capacity = n;
-    return 0;
+    if (h->bound) return HEAP_ERR_FULL;  // fixed-capacity heaps never reallocate
+    return resize_data(h, n);
 }
 
 // Shrink heap capacity to fit size exactly.
 void heap_trim(Heap *h) {
-    if (h->capacity == h->size) return;
-    void **tmp = realloc(h->data, h->size * sizeof(void *));
-    if (tmp) {
-        h->data = tmp;
-        h->capacity = h->size;
+    if (h->capacity == h->size || h->bound) return;
+    resize_data(h, h->size);
+}
+
+// Append `item` and sift it into place, reporting its handle if the
+// position index is active.
+static int push(Heap *h, void *item, HeapHandle *out) {
+    if (h->size == h->capacity) {
+        int rc = heap_reserve(h, grow_capacity(h, h->size + 1));
+        if (rc < 0)
+            return rc;
+    }
+    if (reserve_seq(h, 1) < 0)
+        return HEAP_ERR_FULL;
+    h->data[h->size] = item;
+    stamp(h, h->size);
+    if (h->slot_handle) {
+        if (attach_handle(h, h->size) < 0)
+            return -1;
+        if (out) *out = h->slot_handle[h->size];
     }
+    if (h->lazy)
+        note_pending(h, h->size);
+    else
+        sift_up(h, h->size);
+    h->size++;
+    STAT(stat_size(h));
+    return 0;
+}
+
+// Install a growth/shrink policy (fields left 0 keep their default).
+int heap_set_growth_policy(Heap *h, const HeapGrowthPolicy *policy) {
+    if (!h || !policy) return -1;
+    double factor = policy->grow_factor > 0 ? policy->grow_factor : 2.0;
+    size_t min_cap = policy->min_capacity ? policy->min_capacity : HEAP_DEFAULT_CAP;
+    if (factor <= 1.0 || policy->shrink_below < 0 ||
+        policy->shrink_below * factor >= 1.0)
+        return -1;
+    h->grow_factor = factor;
+    h->max_grow_step = policy->max_grow_step;
+    h->min_capacity = min_cap;
+    h->shrink_below = policy->shrink_below;
+    h->shrink_at = h->shrink_below > 0 ? (size_t)((double)h->capacity * h->shrink_below) : 0;
+    maybe_shrink(h);
+    return 0;
 }
 
 // Insert new element into heap.
 // Automatically grows if needed.
 int heap_insert(Heap *h, void *item) {
-    if (h->size == h->capacity) {
-        if (heap_reserve(h, h->capacity * 2) < 0)
-            return -1;
+    return push(h, item, NULL);
+}
+
+// Insert a batch with a single reservation. Small batches are sifted up
+// one by one; once n sift-ups could cost more than one Floyd pass over
+// the whole array, append and re-heapify. Lazy heaps just append.
+int heap_insert_many(Heap *h, void **items, size_t n) {
+    if (n == 0) return 0;
+    size_t total = h->size + n;
+    if (total < h->size) return -1;
+    if (total > h->capacity) {
+        int rc = heap_reserve(h, grow_capacity(h, total));
+        if (rc < 0)
+            return rc;
     }
-    h->data[h->size] = item;
-    sift_up(h, h->size);
-    h->size++;
+    if (h->slot_handle && reserve_handles(h, total) < 0)
+        return -1;
+    if (reserve_seq(h, n) < 0)
+        return HEAP_ERR_FULL;
+
+    bool rebuild = !h->lazy && cheaper_to_heapify(h, n, total);
+    for (size_t k = 0; k < n; k++) {
+        h->data[h->size] = items[k];
+        stamp(h, h->size);
+        if (h->slot_handle)
+            (void)attach_handle(h, h->size);
+        if (h->lazy)
+            note_pending(h, h->size);
+        else if (!rebuild)
+            sift_up(h, h->size);
+        h->size++;
+    }
+    if (rebuild)
+        heapify(h);
+    STAT(stat_size(h));
     return 0;
 }
 
-// Return top element without removing it.
+// Move every item of `src` into `dst` and leave `src` empty. Goes through
+// heap_insert_many(), which re-heapifies instead of sifting when `src` is
+// large relative to the result. Handles into `src` become invalid.
+int heap_merge(Heap *dst, Heap *src) {
+    if (!dst || !src || dst == src || dst->cmp != src->cmp) return -1;
+    int rc = heap_insert_many(dst, src->data, src->size);
+    if (rc < 0)
+        return rc;
+    heap_clear(src);
+    maybe_shrink(src);
+    return 0;
+}
+
+// Insert and hand back a stable handle for heap_update/heap_remove.
+// The position index is created lazily on first use.
+int heap_insert_handle(Heap *h, void *item, HeapHandle *out) {
+    if (!h->slot_handle && enable_handles(h) < 0)
+        return -1;
+    return push(h, item, out);
+}
+
+// Return top element without removing it. A lazy tail is not ordered
+// here: inserts track its best element, so peek never writes.
 void *heap_peek(const Heap *h) {
-    return (h && h->size > 0) ? h->data[0] : NULL;
+    if (!h || h->size == 0) return NULL;
+    return h->data[top_slot(h)];
+}
+
+// Order any lazily inserted elements now.
+void heap_flush(Heap *h) {
+    if (h) flush(h);
+}
+
+// Remove the root of a non-empty heap.
+static inline void *pop_root(Heap *h) {
+    void *root = h->data[0];
+    if (h->slot_handle) release_handle(h, 0);
+    h->size--;
+    if (h->size > 0) {
+        // Never move slot 0 onto itself: that would rebind the handle
+        // just released.
+        move_slot(h, 0, h->size);
+        sift_down_bottomup(h, 0);
+    }
+    return root;
 }
 
 // Remove and return top element.
 void *heap_extract(Heap *h) {
     if (!h || h->size == 0) return NULL;
-    void *root = h->data[0];
-    h->data[0] = h->data[h->size - 1];
-    h->size--;
-    if (h->size > 0)
-        sift_down(h, 0);
+    flush(h);
+    void *root = pop_root(h);
+    maybe_shrink(h);
     return root;
 }
 
+// Remove up to k top elements into out[], best first.
+size_t heap_extract_many(Heap *h, void **out, size_t k) {
+    if (!h) return 0;
+    flush(h);
+    size_t n = 0;
+    while (n < k && h->size > 0)
+        out[n++] = pop_root(h);
+    maybe_shrink(h);
+    return n;
+}
+
 // Replace top element and reheapify.
 void *heap_replace(Heap *h, void *item) {
     if (!h || h->size == 0) return NULL;
+    flush(h);
+    (void)reserve_seq(h, 1);  // cannot fail: the size does not grow
     void *root = h->data[0];
     h->data[0] = item;
-    sift_down(h, 0);
+    stamp(h, 0);
+    // Like extract + insert: the old root's handle dies and `item` gets
+    // one of its own (the release guarantees a free handle to attach).
+    if (h->slot_handle) {
+        release_handle(h, 0);
+        (void)attach_handle(h, 0);
+    }
+    sift_down_bottomup(h, 0);
     return root;
 }
 
+// Streaming top-k step for bounded heaps. The root is the worst element
+// kept, so anything not strictly below it is rejected with a single
+// comparison and no writes; otherwise it takes the root's place.
+void *heap_offer(Heap *h, void *item) {
+    if (!h) return item;
+    if (!h->bound || h->size < h->bound)
+        return push(h, item, NULL) < 0 ? item : NULL;
+    flush(h);
+    if (h->cmp(item, h->data[0]) >= 0)
+        return item;
+    return heap_replace(h, item);
+}
+
+// Empty the heap into out[] in ascending order (root ends up last).
+size_t heap_drain_sorted(Heap *h, void **out) {
+    if (!h) return 0;
+    flush(h);
+    size_t n = h->size;
+    for (size_t i = n; i-- > 0;)
+        out[i] = pop_root(h);
+    maybe_shrink(h);
+    return n;
+}
+
+// Restore heap order for a handle whose item's priority changed.
+int heap_update(Heap *h, HeapHandle handle) {
+    size_t i = h ? handle_slot(h, handle) : HANDLE_NONE;
+    if (i == HANDLE_NONE) return -1;
+    if (h->pending) {
+        settle(h, i);
+        flush(h);
+        i = handle_slot(h, handle);
+    }
+    if (sift_up(h, i) == i)
+        sift_down(h, i);
+    return 0;
+}
+
+// Remove an arbitrary element by handle.
+void *heap_remove(Heap *h, HeapHandle handle) {
+    size_t i = h ? handle_slot(h, handle) : HANDLE_NONE;
+    if (i == HANDLE_NONE) return NULL;
+    if (h->pending) {
+        settle(h, i);  // the item may have changed before removal
+        flush(h);
+        i = handle_slot(h, handle);
+    }
+    void *item = h->data[i];
+    release_handle(h, i);
+    h->size--;
+    if (i != h->size) {
+        move_slot(h, i, h->size);
+        if (sift_up(h, i) == i)
+            sift_down(h, i);
+    }
+    maybe_shrink(h);
+    return item;
+}
+
+// Look up the item bound to a handle.
+void *heap_handle_item(const Heap *h, HeapHandle handle) {
+    size_t i = h ? handle_slot(h, handle) : HANDLE_NONE;
+    return i == HANDLE_NONE ? NULL : h->data[i];
+}
+
 // Return number of elements in heap.
 size_t heap_size(const Heap *h) {
     return h ? h->size : 0;
@@ -185,25 +963,259 @@ size_t heap_size(const Heap *h) {
 
 // Clear heap contents (does not free memory).
 void heap_clear(Heap *h) {
-    if (h) h->size = 0;
+    if (!h) return;
+    if (h->slot_handle) {
+        for (size_t i = 0; i < h->size; i++)
+            release_handle(h, i);
+    }
+    h->size = 0;
+    h->pending = 0;
+    h->next_seq = 0;
 }
 
 // Clone heap (deep copy of metadata, shallow copy of items).
 Heap *heap_clone(const Heap *h) {
     if (!h) return NULL;
-    Heap *c = heap_create(h->cmp, h->capacity);
+    // A clone of a static heap lives on the default allocator.
+    Heap *c = heap_new(h->cmp, h->capacity, h->arity, h->borrowed ? NULL : &h->mem);
     if (!c) return NULL;
     memcpy(c->data, h->data, h->size * sizeof(void *));
     c->size = h->size;
+    c->lazy = h->lazy;
+    c->blocked = h->blocked;
+    c->pending = h->pending;
+    c->pending_top = h->pending_top;
+    c->grow_factor = h->grow_factor;
+    c->max_grow_step = h->max_grow_step;
+    // A static heap's bound and capacity floor are just its buffer size;
+    // the clone grows like any heap. Bounded heaps stay bounded.
+    if (!h->borrowed) {
+        c->bound = h->bound;
+        c->min_capacity = h->min_capacity;
+    }
+    c->shrink_below = h->shrink_below;
+    c->shrink_at = h->shrink_at;
+    if (h->slot_handle) {
+        // Same handle numbering, so handles are valid on both copies.
+        c->slot_handle = mem_alloc(&c->mem, h->slot_cap * sizeof(size_t));
+        if (c->slot_handle) c->slot_cap = h->slot_cap;
+        c->handle_pos = mem_alloc(&c->mem, h->handle_cap * sizeof(size_t));
+        if (c->handle_pos) c->handle_cap = h->handle_cap;
+        if (!c->slot_handle || !c->handle_pos) {
+            heap_destroy(c);
+            return NULL;
+        }
+        memcpy(c->slot_handle, h->slot_handle, h->size * sizeof(size_t));
+        memcpy(c->handle_pos, h->handle_pos, h->handle_cap * sizeof(size_t));
+        c->free_handle = h->free_handle;
+    }
+    if (h->seq) {
+        c->seq = mem_alloc(&c->mem, c->capacity * sizeof(uint32_t));
+        if (!c->seq) {
+            heap_destroy(c);
+            return NULL;
+        }
+        c->seq_cap = c->capacity;
+        memcpy(c->seq, h->seq, h->size * sizeof(uint32_t));
+        c->next_seq = h->next_seq;
+    }
+    STAT(stat_size(c));
     return c;
 }
 
-// Validate heap structure (for debugging/testing).
+// Counters of one heap (HEAP_STATS builds only).
+int heap_get_stats(const Heap *h, HeapStats *out) {
+    if (!out) return -1;
+    memset(out, 0, sizeof(*out));
+#ifdef HEAP_STATS
+    if (!h) return -1;
+    *out = h->stats;
+    return 0;
+#else
+    (void)h;
+    return -1;
+#endif
+}
+
+void heap_reset_stats(Heap *h) {
+#ifdef HEAP_STATS
+    if (!h) return;
+    size_t bytes = h->stats.bytes_reserved;
+    memset(&h->stats, 0, sizeof(h->stats));
+    h->stats.bytes_reserved = bytes;
+    h->stats.high_water = h->size;
+#else
+    (void)h;
+#endif
+}
+
+// --- Frontier of indices ---
+// A small max-heap of slot indices into a Heap, ordered by the items the
+// slots hold. Because every node dominates its subtree, popping the best
+// frontier index and pushing its children enumerates the heap in priority
+// order without touching it: the first k pops cost O(k log k). The
+// unordered tail of a lazy heap has no subtrees to follow, so all of its
+// slots join the frontier at the start (O(pending)).
+
+typedef struct Frontier {
+    const Heap *heap;
+    size_t *idx;
+    size_t size;
+} Frontier;
+
+static inline bool frontier_before(const Frontier *f, size_t a, size_t b) {
+    return above(f->heap, a, b);
+}
+
+static void frontier_push(Frontier *f, size_t slot) {
+    size_t i = f->size++;
+    while (i > 0) {
+        size_t p = (i - 1) / 2;
+        if (!frontier_before(f, slot, f->idx[p]))
+            break;
+        f->idx[i] = f->idx[p];
+        i = p;
+    }
+    f->idx[i] = slot;
+}
+
+// Place `slot` at frontier position i or below.
+static void frontier_sift_down(Frontier *f, size_t i, size_t slot) {
+    for (;;) {
+        size_t c = 2 * i + 1;
+        if (c >= f->size)
+            break;
+        if (c + 1 < f->size && frontier_before(f, f->idx[c + 1], f->idx[c]))
+            c++;
+        if (!frontier_before(f, f->idx[c], slot))
+            break;
+        f->idx[i] = f->idx[c];
+        i = c;
+    }
+    f->idx[i] = slot;
+}
+
+static size_t frontier_pop(Frontier *f) {
+    size_t top = f->idx[0];
+    size_t last = f->idx[--f->size];
+    frontier_sift_down(f, 0, last);
+    return top;
+}
+
+// Seed an empty frontier with the root of the ordered prefix and every
+// slot of the lazy tail, heapified in O(pending).
+static void frontier_start(Frontier *f) {
+    const Heap *h = f->heap;
+    size_t ordered = h->size - h->pending;
+    if (ordered > 0)
+        f->idx[f->size++] = 0;
+    for (size_t i = ordered; i < h->size; i++)
+        f->idx[f->size++] = i;
+    for (size_t i = f->size / 2; i-- > 0;)
+        frontier_sift_down(f, i, f->idx[i]);
+}
+
+// Pop the best slot and expose its children within the ordered prefix.
+// Frontier must be non-empty.
+static size_t frontier_next(Frontier *f) {
+    size_t slot = frontier_pop(f);
+    size_t ordered = f->heap->size - f->heap->pending;
+    size_t c = child(f->heap, slot), end = c + f->heap->arity;
+    if (end > ordered) end = ordered;
+    for (; c < end; c++)
+        frontier_push(f, c);
+    return slot;
+}
+
+// Frontier size needed for k pops: the seed, then each pop removes one
+// and adds <= arity.
+static inline size_t frontier_bound(const Heap *h, size_t k) {
+    return 1 + h->pending + k * (h->arity - 1);
+}
+
+#define FRONTIER_STACK 256
+
+// Copy the k best elements into out[], best first, leaving h untouched.
+size_t heap_top_k(const Heap *h, void **out, size_t k) {
+    if (!h) return 0;
+    if (k > h->size) k = h->size;
+    if (k == 0) return 0;
+
+    size_t stack[FRONTIER_STACK];
+    size_t need = frontier_bound(h, k);
+    Frontier f = { .heap = h, .idx = stack, .size = 0 };
+    if (need > FRONTIER_STACK) {
+        f.idx = mem_alloc(&h->mem, need * sizeof(size_t));
+        if (!f.idx) return 0;
+    }
+
+    frontier_start(&f);
+    for (size_t n = 0; n < k; n++)
+        out[n] = h->data[frontier_next(&f)];
+
+    if (f.idx != stack) mem_free(&h->mem, f.idx, need * sizeof(size_t));
+    return k;
+}
+
+// Lazy priority-order walk: a Frontier kept alive between calls.
+struct HeapOrderedIter {
+    Frontier f;
+    size_t cap;          // allocated frontier entries
+    HeapAllocator mem;   // copy, so destroy does not need the heap
+};
+
+HeapOrderedIter *heap_ordered_iter(const Heap *h) {
+    if (!h) return NULL;
+    // Static heaps have no allocator of their own.
+    const HeapAllocator *mem = h->borrowed ? &std_allocator : &h->mem;
+    HeapOrderedIter *it = mem_alloc(mem, sizeof(*it));
+    if (!it) return NULL;
+    it->mem = *mem;
+    it->cap = frontier_bound(h, 1);
+    it->f = (Frontier){ .heap = h, .size = 0 };
+    it->f.idx = mem_alloc(mem, it->cap * sizeof(size_t));
+    if (!it->f.idx) {
+        mem_free(mem, it, sizeof(*it));
+        return NULL;
+    }
+    frontier_start(&it->f);
+    return it;
+}
+
+bool heap_ordered_iter_next(HeapOrderedIter *it, void **out) {
+    if (!it || it->f.size == 0) return false;
+    // One pop, then up to arity pushes.
+    size_t need = it->f.size - 1 + it->f.heap->arity;
+    if (need > it->cap) {
+        size_t cap = it->cap * 2 > need ? it->cap * 2 : need;
+        size_t *idx = mem_realloc(&it->mem, it->f.idx, it->cap * sizeof(size_t),
+                                  cap * sizeof(size_t));
+        if (!idx) return false;
+        it->f.idx = idx;
+        it->cap = cap;
+    }
+    *out = it->f.heap->data[frontier_next(&it->f)];
+    return true;
+}
+
+void heap_ordered_iter_destroy(HeapOrderedIter *it) {
+    if (!it) return;
+    HeapAllocator mem = it->mem;
+    mem_free(&mem, it->f.idx, it->cap * sizeof(size_t));
+    mem_free(&mem, it, sizeof(*it));
+}
+
+// Validate heap structure (for debugging/testing). A lazy tail is not
+// ordered yet, so only the prefix before it is checked.
 bool heap_validate(const Heap *h) {
     if (!h) return false;
-    for (size_t i = 1; i < h->size; i++) {
-        size_t p = parent(i);
-        if (h->cmp(h->data[i], h->data[p]) > 0)
+    for (size_t i = 1; i < h->size - h->pending; i++) {
+        size_t p = parent(h, i);
+        if (above(h, i, p))
+            return false;
+    }
+    for (size_t i = 0; h->slot_handle && i < h->size; i++) {
+        if (handle_slot(h, h->slot_handle[i]) != i)
             return false;
     }
     return true;
@@ -235,14 +1247,297 @@ bool heap_iter_next(HeapIter *it, void **out) {
 }
 
 // --- Heap sort utility ---
-// Turns arbitrary array into a heap, then repeatedly extracts.
-// Runs in O(n log n), in-place but not stable.
+// Heapifies the caller's array where it lies, then repeatedly swaps the
+// root behind the shrinking heap. O(n log n), no allocation, not stable.
 void heap_sort(void **arr, size_t n, heap_cmp_fn cmp) {
-    Heap *h = heap_build(arr, n, cmp);
-    if (!h) return;
-    for (size_t i = n; i-- > 0;)
-        arr[i] = heap_extract(h);
-    heap_destroy(h);
+    if (!cmp || n < 2) return;
+    // A stack-only Heap header viewing arr: no copy, nothing to free.
+    Heap v = { .data = arr, .size = n, .capacity = n, .cmp = cmp,
+               .arity = 2, .shift = 1 };
+    heapify(&v);
+    while (v.size > 1) {
+        swap(&v, 0, v.size - 1);
+        v.size--;
+        sift_down_bottomup(&v, 0);
+    }
+}
+
+// Keep the k lowest of arr[0..n) in arr[0..k) as a max-heap (the bounded
+// heap of heap_offer, run in place): each later element only costs a
+// comparison with the root unless it displaces it. O(n log k).
+static void select_into_prefix(Heap *v, void **arr, size_t n) {
+    heapify(v);
+    for (size_t i = v->size; i < n; i++) {
+        if (v->cmp(arr[i], arr[0]) >= 0)
+            continue;
+        void *tmp = arr[0];
+        arr[0] = arr[i];
+        arr[i] = tmp;
+        sift_down_bottomup(v, 0);
+    }
+}
+
+// Move the k lowest elements to arr[0..k), unordered.
+void heap_select(void **arr, size_t n, size_t k, heap_cmp_fn cmp) {
+    if (!cmp || k == 0 || k >= n) return;
+    Heap v = { .data = arr, .size = k, .capacity = k, .cmp = cmp,
+               .arity = 2, .shift = 1 };
+    select_into_prefix(&v, arr, n);
+}
+
+// Move the k lowest elements to arr[0..k) in ascending order; the rest
+// end up in arr[k..n) in no particular order.
+void heap_partial_sort(void **arr, size_t n, size_t k, heap_cmp_fn cmp) {
+    if (!cmp || k == 0) return;
+    if (k >= n) { heap_sort(arr, n, cmp); return; }
+    Heap v = { .data = arr, .size = k, .capacity = k, .cmp = cmp,
+               .arity = 2, .shift = 1 };
+    select_into_prefix(&v, arr, n);
+    while (v.size > 1) {
+        swap(&v, 0, v.size - 1);
+        v.size--;
+        sift_down_bottomup(&v, 0);
+    }
+}
+
+// --- By-value sort (qsort-compatible) ---
+
+// Swap two elem_size-byte elements through a small bounce buffer.
+static inline void swap_bytes(unsigned char *a, unsigned char *b, size_t n) {
+    unsigned char tmp[64];
+    while (n > 0) {
+        size_t k = n < sizeof(tmp) ? n : sizeof(tmp);
+        memcpy(tmp, a, k);
+        memcpy(a, b, k);
+        memcpy(b, tmp, k);
+        a += k; b += k; n -= k;
+    }
+}
+
+// Bottom-up variant for the sort loop (see sift_down_bottomup). Elements
+// have no fixed size to hold in a local, so the element is swapped down
+// the path instead of leaving a hole.
+static void sift_down_bytes_bottomup(unsigned char *base, size_t n, size_t size,
+                                     size_t i, heap_cmp_fn cmp) {
+    for (;;) {
+        size_t l = 2 * i + 1;
+        if (l >= n)
+            break;
+        if (l + 1 < n && cmp(base + (l + 1) * size, base + l * size) > 0)
+            l++;
+        swap_bytes(base + i * size, base + l * size, size);
+        i = l;
+    }
+    while (i > 0) {
+        size_t p = (i - 1) / 2;
+        if (cmp(base + i * size, base + p * size) <= 0)
+            break;
+        swap_bytes(base + i * size, base + p * size, size);
+        i = p;
+    }
+}
+
+static void sift_down_bytes(unsigned char *base, size_t n, size_t size,
+                            size_t i, heap_cmp_fn cmp) {
+    for (;;) {
+        size_t l = 2 * i + 1, largest = i;
+        if (l < n && cmp(base + l * size, base + largest * size) > 0)
+            largest = l;
+        if (l + 1 < n && cmp(base + (l + 1) * size, base + largest * size) > 0)
+            largest = l + 1;
+        if (largest == i)
+            break;
+        swap_bytes(base + i * size, base + largest * size, size);
+        i = largest;
+    }
+}
+
+// Same algorithm as heap_sort over an array of by-value elements; cmp
+// receives pointers to elements, exactly as with qsort().
+void heap_sort_typed(void *base, size_t n, size_t elem_size, heap_cmp_fn cmp) {
+    if (!base || !cmp || elem_size == 0 || n < 2) return;
+    unsigned char *b = base;
+    for (size_t i = n / 2; i-- > 0;)
+        sift_down_bytes(b, n, elem_size, i, cmp);
+    for (size_t end = n - 1; end > 0; end--) {
+        swap_bytes(b, b + end * elem_size, elem_size);
+        sift_down_bytes_bottomup(b, end, elem_size, 0, cmp);
+    }
+}
+
+// --- Parallel build and sort ---
+// Below PARALLEL_MIN elements the thread start-up costs more than it saves.
+
+#define PARALLEL_MIN     (1u << 16)
+#define PARALLEL_MAX_THR 64
+
+static unsigned pick_threads(unsigned nthreads, size_t n) {
+    if (nthreads == 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+        long c = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = c > 0 ? (unsigned)c : 1;
+#else
+        nthreads = 1;
+#endif
+    }
+    if (nthreads > PARALLEL_MAX_THR) nthreads = PARALLEL_MAX_THR;
+    if (n < PARALLEL_MIN) nthreads = 1;
+    return nthreads;
+}
+
+// Run fn(args[t]) on nthreads threads (the caller runs the last share).
+// If a thread cannot be started its share is run inline.
+static void run_parallel(void *(*fn)(void *), void *args, size_t arg_size,
+                         unsigned nthreads) {
+    pthread_t tid[PARALLEL_MAX_THR];
+    bool started[PARALLEL_MAX_THR];
+    for (unsigned t = 0; t + 1 < nthreads; t++) {
+        void *arg = (char *)args + t * arg_size;
+        started[t] = pthread_create(&tid[t], NULL, fn, arg) == 0;
+        if (!started[t]) fn(arg);
+    }
+    fn((char *)args + (nthreads - 1) * arg_size);
+    for (unsigned t = 0; t + 1 < nthreads; t++)
+        if (started[t]) pthread_join(tid[t], NULL);
+}
+
+typedef struct BuildTask {
+    Heap view;            // private copy of the header: sifts write no shared state
+    size_t first, last;   // subtree roots [first, last) at the split depth
+} BuildTask;
+
+// Floyd within each assigned subtree, deepest level first. In a binary
+// heap the descendants of r at relative depth k are the 2^k consecutive
+// slots starting at (r + 1) * 2^k - 1.
+static void *build_subtrees(void *arg) {
+    BuildTask *t = arg;
+    Heap *h = &t->view;
+    for (size_t r = t->first; r < t->last; r++) {
+        size_t depth = 0;
+        while ((r + 1) << (depth + 1) <= h->size) depth++;
+        for (size_t k = depth + 1; k-- > 0;) {
+            size_t lo = ((r + 1) << k) - 1, hi = lo + ((size_t)1 << k);
+            if (hi > h->size) hi = h->size;
+            for (size_t i = hi; i-- > lo;)
+                if (child(h, i) < h->size)
+                    sift_down(h, i);
+        }
+    }
+    return NULL;
+}
+
+// Heapify a binary heap in place with nthreads: independent subtrees
+// below a split depth in parallel, then the few levels above it serially.
+static void heapify_parallel(Heap *h, unsigned nthreads) {
+    if (nthreads <= 1) { heapify(h); return; }
+
+    // Split where there are >= 4 subtrees per thread.
+    unsigned d = 0;
+    while (((size_t)1 << d) < 4 * (size_t)nthreads) d++;
+    size_t first = ((size_t)1 << d) - 1, last = ((size_t)1 << (d + 1)) - 1;
+    if (last > h->size) last = h->size;
+    if (first >= last) { heapify(h); return; }
+
+    BuildTask tasks[PARALLEL_MAX_THR];
+    size_t roots = last - first;
+    for (unsigned t = 0; t < nthreads; t++) {
+        tasks[t].view = *h;
+        STAT(memset(&tasks[t].view.stats, 0, sizeof(HeapStats)));
+        tasks[t].first = first + roots * t / nthreads;
+        tasks[t].last = first + roots * (t + 1) / nthreads;
+    }
+    run_parallel(build_subtrees, tasks, sizeof(tasks[0]), nthreads);
+#ifdef HEAP_STATS
+    for (unsigned t = 0; t < nthreads; t++) {
+        const HeapStats *v = &tasks[t].view.stats;
+        h->stats.compares += v->compares;
+        h->stats.swaps += v->swaps;
+        h->stats.sift_downs += v->sift_downs;
+        for (size_t d = 0; d < HEAP_STATS_DEPTH_BUCKETS; d++)
+            h->stats.depth_hist[d] += v->depth_hist[d];
+    }
+#endif
+
+    for (size_t i = first; i-- > 0;)
+        sift_down(h, i);
+}
+
+// Build heap from an existing array using several threads.
+Heap *heap_build_parallel(void **arr, size_t n, heap_cmp_fn cmp, unsigned nthreads) {
+    if (!cmp) return NULL;
+    Heap *h = heap_new(cmp, n, 2, NULL);
+    if (!h) return NULL;
+    if (n > 0)
+        memcpy(h->data, arr, n * sizeof(void *));
+    h->size = n;
+    heapify_parallel(h, pick_threads(nthreads, n));
+    STAT(stat_size(h));
+    return h;
+}
+
+typedef struct SortTask {
+    void **arr;
+    size_t n;
+    heap_cmp_fn cmp;
+} SortTask;
+
+static void *sort_chunk(void *arg) {
+    SortTask *t = arg;
+    heap_sort(t->arr, t->n, t->cmp);
+    return NULL;
+}
+
+// Min-heap of sorted runs keyed by their current head, for the merge.
+typedef struct MergeRun {
+    void **next, **end;
+} MergeRun;
+
+static void merge_sift_down(MergeRun *runs, size_t n, size_t i, heap_cmp_fn cmp) {
+    MergeRun r = runs[i];
+    for (;;) {
+        size_t c = 2 * i + 1;
+        if (c >= n)
+            break;
+        if (c + 1 < n && cmp(*runs[c + 1].next, *runs[c].next) < 0)
+            c++;
+        if (cmp(*runs[c].next, *r.next) >= 0)
+            break;
+        runs[i] = runs[c];
+        i = c;
+    }
+    runs[i] = r;
+}
+
+// Sort ascending: heap sort per chunk in parallel, then a k-way merge
+// driven by a small heap of run heads. The merge needs an n-slot buffer;
+// if it cannot be allocated the array is sorted serially instead.
+void heap_sort_parallel(void **arr, size_t n, heap_cmp_fn cmp, unsigned nthreads) {
+    if (!cmp || n < 2) return;
+    nthreads = pick_threads(nthreads, n);
+    void **out = nthreads > 1 ? malloc(n * sizeof(void *)) : NULL;
+    if (!out) { heap_sort(arr, n, cmp); return; }
+
+    SortTask tasks[PARALLEL_MAX_THR];
+    MergeRun runs[PARALLEL_MAX_THR];
+    for (unsigned t = 0; t < nthreads; t++) {
+        size_t lo = n * t / nthreads, hi = n * (t + 1) / nthreads;
+        tasks[t] = (SortTask){ .arr = arr + lo, .n = hi - lo, .cmp = cmp };
+        runs[t] = (MergeRun){ .next = arr + lo, .end = arr + hi };
+    }
+    run_parallel(sort_chunk, tasks, sizeof(tasks[0]), nthreads);
+
+    size_t nruns = nthreads;
+    for (size_t i = nruns / 2; i-- > 0;)
+        merge_sift_down(runs, nruns, i, cmp);
+    for (size_t k = 0; k < n; k++) {
+        out[k] = *runs[0].next++;
+        if (runs[0].next == runs[0].end)
+            runs[0] = runs[--nruns];
+        if (nruns > 0)
+            merge_sift_down(runs, nruns, 0, cmp);
+    }
+    memcpy(arr, out, n * sizeof(void *));
+    free(out);
 }
 
 // -----------------------------------------------------------
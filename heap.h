@@ -3,6 +3,7 @@
 
 #include <stddef.h> // size_t
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -10,8 +11,129 @@ extern "C" {
 
 typedef int (*heap_cmp_fn)(const void *a, const void *b);
 
+/** Error codes returned by the int-valued functions (0 = success). */
+#define HEAP_ERR_NOMEM (-1)  /**< allocation failed */
+#define HEAP_ERR_FULL  (-2)  /**< fixed-capacity heap (bounded/static) is full */
+
 typedef struct Heap Heap;
 
+/**
+ * @brief Stable reference to an element, see heap_insert_handle().
+ *
+ * A handle stays valid while its element is in the heap, wherever sifts
+ * move it. Once the element leaves (extract, replace, remove, clear) the
+ * handle is dead and its value may be reused for a later insert.
+ */
+typedef size_t HeapHandle;
+
+/**
+ * @brief Caller-provided storage for a Heap header, see heap_init_static().
+ *
+ * Lets a heap live on the stack, in a static or in shared memory without
+ * any allocation. HEAP_STORAGE_SIZE is checked against the real struct at
+ * compile time.
+ */
+#define HEAP_STORAGE_SIZE (64 * sizeof(void *))
+
+typedef union HeapStorage {
+    max_align_t align;
+    unsigned char bytes[HEAP_STORAGE_SIZE];
+} HeapStorage;
+
+/** Largest supported arity (children per node). */
+#define HEAP_MAX_ARITY 8
+
+/**
+ * @brief Custom memory source for a heap.
+ *
+ * Every allocation a heap makes (its header, backing array and position
+ * index) goes through these callbacks, which receive `ctx` and the size
+ * of the block, so arena or pool allocators need no bookkeeping of their
+ * own. The struct is copied at creation time.
+ */
+typedef struct HeapAllocator {
+    void *(*alloc_fn)(void *ctx, size_t size);
+    /** May be NULL: the heap then allocates, copies and frees. */
+    void *(*realloc_fn)(void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free_fn)(void *ctx, void *ptr, size_t size);
+    void *ctx;
+} HeapAllocator;
+
+/**
+ * @brief Capacity growth and automatic shrink policy.
+ *
+ * Zero fields mean default. When full, capacity becomes
+ * capacity * grow_factor, limited to max_grow_step extra slots and never
+ * below min_capacity (so even a heap built from an empty array grows).
+ * With shrink_below > 0, removals that leave size < capacity * shrink_below
+ * shrink the array to about size * grow_factor (never below min_capacity).
+ * shrink_below * grow_factor must be < 1; the gap between the two
+ * thresholds is the hysteresis that prevents realloc thrash.
+ */
+typedef struct HeapGrowthPolicy {
+    double grow_factor;    /**< default 2.0, must be > 1 */
+    size_t max_grow_step;  /**< default 0 = unlimited */
+    size_t min_capacity;   /**< default 16 */
+    double shrink_below;   /**< default 0 = never shrink automatically */
+} HeapGrowthPolicy;
+
+/**
+ * @brief Array layout of a heap, see HeapConfig.layout.
+ *
+ * HEAP_LAYOUT_IMPLICIT is the classic breadth-first array. HEAP_LAYOUT_BLOCKED
+ * stores every pair of sibling subtrees, three levels deep plus one pair
+ * of the fourth, in 16 consecutive slots on a 128-byte boundary (two
+ * cache lines, fetched together by adjacent-line prefetchers), so a
+ * sift misses the cache once per 3 levels instead of once per level. It
+ * pays off for heaps far larger than the last-level cache and costs a
+ * little index arithmetic otherwise.
+ *
+ * There is no page-level blocking: below the top few hundred slots each
+ * block lies on a different page, so a sift still takes about one TLB
+ * miss per 3 levels. For heaps far beyond the TLB reach, back the array
+ * with huge pages (e.g. through a HeapAllocator).
+ */
+typedef enum HeapLayout {
+    HEAP_LAYOUT_IMPLICIT = 0,
+    HEAP_LAYOUT_BLOCKED = 1
+} HeapLayout;
+
+/**
+ * @brief Optional heap configuration for heap_create_ex().
+ *
+ * Zero-initialize and set only the fields you need; zero means default.
+ */
+typedef struct HeapConfig {
+    /**
+     * Children per node: 2 (default), 4 or 8. Higher arity makes the tree
+     * shallower; the backing array is aligned so that all children of a
+     * node share one 64-byte cache line.
+     */
+    unsigned arity;
+    /** Memory source; NULL means malloc/realloc/free. */
+    const HeapAllocator *allocator;
+    /**
+     * Buffer inserts: heap_insert() and friends only append to an
+     * unordered tail (and note its best element), which is ordered
+     * (sift-ups or one Floyd pass, whichever is cheaper) by the next call
+     * that changes the heap (extract, replace, update, remove, ...) or by
+     * heap_flush(). Read-only calls (peek, top_k, heap_ordered_iter) work
+     * around the tail without writing to it. Makes insert bursts cost
+     * little more than a copy.
+     */
+    bool lazy_insert;
+    /** Array layout; HEAP_LAYOUT_BLOCKED requires arity 2. */
+    HeapLayout layout;
+    /**
+     * FIFO among equals: elements the comparator calls equal leave in
+     * insertion order, with no sequence number in the items. The heap
+     * keeps a 32-bit insertion sequence beside each slot and reads it
+     * only when the comparator returns 0. Merged items count as inserted
+     * by heap_merge(), in src's array order.
+     */
+    bool stable;
+} HeapConfig;
+
 /**
  * @brief Create a new heap.
  *
@@ -21,6 +143,55 @@ typedef struct Heap Heap;
  */
 Heap *heap_create(heap_cmp_fn cmp, size_t capacity);
 
+/**
+ * @brief Create a new heap with explicit configuration.
+ *
+ * @param cmp Comparator function. Must return positive if a > b.
+ * @param capacity Optional initial capacity (0 for default).
+ * @param cfg Configuration, or NULL for defaults (same as heap_create).
+ * @return Pointer to Heap or NULL on failure or unsupported config.
+ */
+Heap *heap_create_ex(heap_cmp_fn cmp, size_t capacity, const HeapConfig *cfg);
+
+/**
+ * @brief Create a new heap backed by a custom allocator.
+ *
+ * Same as heap_create_ex() with only HeapConfig.allocator set. Heaps
+ * cloned from this one use the same allocator.
+ */
+Heap *heap_create_with_allocator(heap_cmp_fn cmp, size_t capacity,
+                                 const HeapAllocator *alloc);
+
+/**
+ * @brief Create a bounded heap for streaming top-k selection.
+ *
+ * The heap keeps at most k elements in storage allocated up front and
+ * never reallocates: heap_reserve() beyond k fails and heap_trim() is a
+ * no-op. Feed it with heap_offer(); it retains the k elements that compare
+ * lowest, with the largest of them at the root. Inserting into a full
+ * bounded heap returns HEAP_ERR_FULL. To keep the k *best*
+ * items, pass a comparator that orders worse items as greater.
+ *
+ * @param cmp Comparator function. Must return positive if a > b.
+ * @param k Maximum number of elements (must be > 0).
+ * @return Pointer to Heap or NULL on failure.
+ */
+Heap *heap_create_bounded(heap_cmp_fn cmp, size_t k);
+
+/**
+ * @brief Initialize a fixed-capacity heap entirely in caller-owned memory.
+ *
+ * The heap header lives in `storage` and its elements in buf[0..cap).
+ * Nothing is ever allocated: inserting into a full heap returns
+ * HEAP_ERR_FULL, and features that need extra memory (handles, heap_top_k
+ * beyond a small k) fail. Like a bounded heap it supports heap_offer().
+ * heap_destroy() is a no-op (both buffers stay the caller's); heap_clone()
+ * returns a normal malloc-backed heap. Binary layout only.
+ *
+ * @return The heap (pointing into storage), or NULL on bad arguments.
+ */
+Heap *heap_init_static(HeapStorage *storage, void **buf, size_t cap, heap_cmp_fn cmp);
+
 /**
  * @brief Build a heap from existing array (heapify).
  *
@@ -31,6 +202,17 @@ Heap *heap_create(heap_cmp_fn cmp, size_t capacity);
  */
 Heap *heap_build(void **arr, size_t n, heap_cmp_fn cmp);
 
+/**
+ * @brief Build a heap from existing array using several threads.
+ *
+ * Same result contract as heap_build(). Subtrees below a split level are
+ * heapified concurrently, then the top levels serially. Small inputs are
+ * built on the calling thread.
+ *
+ * @param nthreads Worker threads (0 = number of online CPUs).
+ */
+Heap *heap_build_parallel(void **arr, size_t n, heap_cmp_fn cmp, unsigned nthreads);
+
 /**
  * @brief Free heap memory.
  */
@@ -38,25 +220,134 @@ void heap_destroy(Heap *h);
 
 /**
  * @brief Insert new element into heap.
- * @return 0 on success, -1 on allocation failure.
+ * @return 0 on success, HEAP_ERR_NOMEM on allocation failure,
+ *         HEAP_ERR_FULL if a fixed-capacity heap is full.
  */
 int heap_insert(Heap *h, void *item);
 
+/**
+ * @brief Insert a batch of elements with a single capacity reservation.
+ *
+ * Picks per batch between n individual sift-ups and appending followed by
+ * one O(size + n) Floyd re-heapify, whichever bounds fewer comparisons.
+ * Either all items are inserted or (on failure) none.
+ * @return 0 on success, HEAP_ERR_NOMEM or HEAP_ERR_FULL.
+ */
+int heap_insert_many(Heap *h, void **items, size_t n);
+
+/**
+ * @brief Move all elements of src into dst, leaving src empty.
+ *
+ * Costs O(m log n) for a small src and O(n + m) (one re-heapify) for a
+ * large one; see heap_insert_many(). Both heaps must use the same
+ * comparator. Handles into src are invalidated. On failure both heaps are
+ * unchanged. For O(1) melds use PairingHeap (pairing_heap.h).
+ * @return 0 on success, -1 on bad arguments, HEAP_ERR_NOMEM or HEAP_ERR_FULL.
+ */
+int heap_merge(Heap *dst, Heap *src);
+
+/**
+ * @brief Insert new element and return a handle to it.
+ *
+ * The first call allocates a position index (one slot and one handle
+ * entry per element) that sifts keep up to date from then on; heaps that
+ * never call this pay nothing.
+ *
+ * @param out Receives the handle (may be NULL).
+ * @return 0 on success, HEAP_ERR_NOMEM or HEAP_ERR_FULL.
+ */
+int heap_insert_handle(Heap *h, void *item, HeapHandle *out);
+
+/**
+ * @brief Restore heap order after the priority of a handle's item changed.
+ *
+ * Covers both increase- and decrease-key in O(log n). On a lazy_insert
+ * heap with a pending tail this also orders the tail.
+ * @return 0 on success, -1 if the handle is not live.
+ */
+int heap_update(Heap *h, HeapHandle handle);
+
+/**
+ * @brief Remove an arbitrary element by handle in O(log n).
+ *
+ * The item's priority may have changed since it was last ordered.
+ * @return The removed item, or NULL if the handle is not live.
+ */
+void *heap_remove(Heap *h, HeapHandle handle);
+
+/**
+ * @brief Item currently bound to a handle, or NULL if not live.
+ */
+void *heap_handle_item(const Heap *h, HeapHandle handle);
+
 /**
  * @brief Get root element without removing it.
+ *
+ * Never writes to the heap, so it is safe alongside other readers. On a
+ * lazy_insert heap the result is the better of the ordered root and the
+ * pending tail's best element, O(1); the next extract returns it.
  */
 void *heap_peek(const Heap *h);
 
+/**
+ * @brief Order the pending tail of a lazy_insert heap now.
+ *
+ * Never needed for correctness; useful to move the cost out of a
+ * latency-sensitive call. Until then heap_top_k() and heap_ordered_iter()
+ * also spend O(pending) per call on the tail. A no-op on other heaps.
+ */
+void heap_flush(Heap *h);
+
 /**
  * @brief Remove and return root element.
  */
 void *heap_extract(Heap *h);
 
+/**
+ * @brief Remove up to k top elements into out[], best first.
+ * @return Number of elements written (less than k if the heap ran dry).
+ */
+size_t heap_extract_many(Heap *h, void **out, size_t k);
+
+/**
+ * @brief Copy the k best elements into out[], best first, without
+ *        modifying the heap.
+ *
+ * Walks the heap with a small auxiliary frontier of indices, O(k log k).
+ * The pending tail of a lazy_insert heap joins the frontier up front,
+ * adding O(pending) time and space. The frontier lives on the stack when
+ * small and is malloc'd otherwise.
+ * @return Number of elements written (min(k, size)), or 0 on allocation
+ *         failure.
+ */
+size_t heap_top_k(const Heap *h, void **out, size_t k);
+
 /**
  * @brief Replace root element with new item.
  */
 void *heap_replace(Heap *h, void *item);
 
+/**
+ * @brief Offer an item to a bounded heap.
+ *
+ * While the heap has room the item is inserted (on an unbounded heap this
+ * is just heap_insert). Once full, items that do
+ * not compare strictly lower than the root are rejected without touching
+ * the array; otherwise the item replaces the root (one sift-down).
+ *
+ * @return NULL if the item was added without eviction, the evicted former
+ *         root if the item displaced it, or `item` itself if rejected.
+ */
+void *heap_offer(Heap *h, void *item);
+
+/**
+ * @brief Move all elements into out[] in ascending order, emptying the heap.
+ *
+ * For a bounded heap this yields the retained k elements best first.
+ * @return Number of elements written.
+ */
+size_t heap_drain_sorted(Heap *h, void **out);
+
 /**
  * @brief Number of elements in heap.
  */
@@ -64,9 +355,20 @@ size_t heap_size(const Heap *h);
 
 /**
  * @brief Ensure heap capacity for at least n elements.
+ * @return 0 on success, HEAP_ERR_NOMEM, or HEAP_ERR_FULL if the heap has a
+ *         fixed capacity below n.
  */
 int heap_reserve(Heap *h, size_t n);
 
+/**
+ * @brief Set the growth/shrink policy of a heap.
+ *
+ * Takes effect immediately (a heap already below the shrink threshold is
+ * shrunk). Fixed-capacity heaps ignore the policy.
+ * @return 0 on success, -1 if the policy is invalid.
+ */
+int heap_set_growth_policy(Heap *h, const HeapGrowthPolicy *policy);
+
 /**
  * @brief Trim heap capacity down to current size.
  */
@@ -84,10 +386,48 @@ Heap *heap_clone(const Heap *h);
 
 /**
  * @brief Check heap validity (for debugging).
+ *
+ * The unordered tail of a lazy_insert heap is not checked.
  * @return true if valid heap property.
  */
 bool heap_validate(const Heap *h);
 
+/** Buckets in HeapStats.depth_hist; the last one collects deeper sifts. */
+#define HEAP_STATS_DEPTH_BUCKETS 16
+
+/**
+ * @brief Operation counters of one heap, see heap_get_stats().
+ *
+ * Only maintained when the library is compiled with -DHEAP_STATS
+ * (make STATS=1); otherwise no counter exists and the sift loops are
+ * unchanged. HeapStorage has the same size either way; heap.c asserts
+ * at compile time that the counters still fit in it.
+ */
+typedef struct HeapStats {
+    uint64_t compares;    /**< comparator calls made by sifts */
+    uint64_t swaps;       /**< element moves made by sifts */
+    uint64_t sift_ups;    /**< sift-up passes */
+    uint64_t sift_downs;  /**< sift-down passes (a bottom-up sift counts
+                               as one sift-down plus one sift-up) */
+    /** Passes by number of levels moved: depth_hist[d] for d levels. */
+    uint64_t depth_hist[HEAP_STATS_DEPTH_BUCKETS];
+    uint64_t reallocs;    /**< resizes of the backing array (grow or shrink) */
+    size_t bytes_reserved; /**< current size of the backing array */
+    size_t high_water;    /**< largest size the heap has reached */
+} HeapStats;
+
+/**
+ * @brief Copy the heap's counters into *out.
+ * @return 0 on success, -1 if the library was built without HEAP_STATS
+ *         (*out is zeroed then).
+ */
+int heap_get_stats(const Heap *h, HeapStats *out);
+
+/**
+ * @brief Zero the counters; high_water restarts at the current size.
+ */
+void heap_reset_stats(Heap *h);
+
 /**
  * @brief Print heap as tree (debug).
  */
@@ -104,11 +444,79 @@ typedef struct HeapIter {
 HeapIter heap_iter(const Heap *h);
 bool heap_iter_next(HeapIter *it, void **out);
 
+typedef struct HeapOrderedIter HeapOrderedIter;
+
+/**
+ * @brief Start a walk over the heap in priority order, best first.
+ *
+ * Neither copies nor modifies the heap: a frontier of slot indices grows
+ * by at most arity - 1 entries per element produced, so the first k
+ * elements cost O(k log k) regardless of the heap's size (plus
+ * O(pending) up front for the tail of a lazy_insert heap). The heap must
+ * not be modified while the iterator is in use.
+ *
+ * @return Iterator (free with heap_ordered_iter_destroy) or NULL.
+ */
+HeapOrderedIter *heap_ordered_iter(const Heap *h);
+
+/**
+ * @brief Produce the next element in priority order.
+ * @return false when every element was produced (or the frontier could
+ *         not grow).
+ */
+bool heap_ordered_iter_next(HeapOrderedIter *it, void **out);
+
+/**
+ * @brief Free the iterator (may outlive the heap).
+ */
+void heap_ordered_iter_destroy(HeapOrderedIter *it);
+
 /**
  * @brief Heap sort utility
+ *
+ * Sorts arr ascending in place. Performs no allocation, so it cannot fail.
  */
 void heap_sort(void **arr, size_t n, heap_cmp_fn cmp);
 
+/**
+ * @brief Partial sort: put the k lowest elements in arr[0..k), ascending.
+ *
+ * arr[0..k) is sorted ascending, as heap_sort() would order it; like
+ * heap_sort(), the relative order of equal elements is unspecified, and
+ * which of several equal elements straddling position k end up in the
+ * prefix is unspecified too. arr[k..n) holds the remaining elements in
+ * no particular order. Uses a size-k max-heap
+ * inside arr, O(n log k), in place, no allocation. For the k highest,
+ * pass a comparator with the order reversed.
+ */
+void heap_partial_sort(void **arr, size_t n, size_t k, heap_cmp_fn cmp);
+
+/**
+ * @brief Selection: put the k lowest elements in arr[0..k), unordered.
+ *
+ * Like heap_partial_sort() without sorting the prefix.
+ */
+void heap_select(void **arr, size_t n, size_t k, heap_cmp_fn cmp);
+
+/**
+ * @brief Parallel sort: per-chunk heap sort plus a k-way merge.
+ *
+ * Sorts arr ascending like heap_sort(), but allocates an n-slot merge
+ * buffer; if that allocation fails it falls back to heap_sort(). Small
+ * inputs are sorted on the calling thread.
+ *
+ * @param nthreads Worker threads (0 = number of online CPUs).
+ */
+void heap_sort_parallel(void **arr, size_t n, heap_cmp_fn cmp, unsigned nthreads);
+
+/**
+ * @brief Heap sort for arrays of by-value elements (qsort-compatible).
+ *
+ * @param base Array of n elements, each elem_size bytes.
+ * @param cmp Called with pointers to two elements, as with qsort().
+ */
+void heap_sort_typed(void *base, size_t n, size_t elem_size, heap_cmp_fn cmp);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,652 @@
+// Benchmark harness for every heap variant
+// -----------------------------------------------
+// - Operations: insert, extract, replace, build, sort
+// - Sizes: 1K, 10K, ... up to -n (default 1M; 100M needs ~4 GB of RAM)
+// - Distributions: random, sorted, reverse, dups (16 distinct keys)
+// - Comparators: ptr (key in the pointer), deref (key behind the
+//   pointer), record (16-byte records compared with memcmp)
+// - Variants: binary, 4-ary, 8-ary, blocked and lazy Heaps, parallel
+//   build/sort, ConcHeap, and the comparator-free template, keyed and
+//   keyed4 heaps (reported once per distribution with cmp = inline)
+//
+// Writes one CSV row per (variant, op, dist, cmp, n) to stdout:
+// ns/op, comparator calls/op (empty for inline variants) and cache
+// misses/op from perf_event_open (empty where the kernel refuses it).
+// Small sizes are repeated up to BENCH_MIN_OPS operations per row.
+//
+// Build and run with `make bench`; pass options via BENCH_ARGS:
+//   -n max_n   -t threads   -v variant[,variant]   -o op[,op]
+//
+// -----------------------------------------------
+
+#define _GNU_SOURCE  // syscall() for perf_event_open
+
+#include "heap.h"
+#include "keyed_heap.h"
+#include "conc_heap.h"
+#include "heap_template.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#define BENCH_MIN_OPS   ((size_t)1 << 18)
+#define BENCH_DEFAULT_N ((size_t)1000000)
+#define BENCH_MAX_THR   64
+#define BENCH_DUP_KEYS  16
+
+HEAP_DEFINE(u64_heap, uint64_t, a < b)
+
+static struct {
+    size_t max_n;
+    unsigned threads;
+    const char *variants;  // NULL = all
+    const char *ops;       // NULL = all
+} opt = { BENCH_DEFAULT_N, 0, NULL, NULL };
+
+static volatile uintptr_t sink;  // keeps results observable
+
+static void *need(void *p) {
+    if (!p) {
+        fprintf(stderr, "heap_bench: out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+// Is `name` one of the comma-separated entries of `list`?
+static bool listed(const char *list, const char *name) {
+    if (!list) return true;
+    size_t len = strlen(name);
+    for (const char *p = list; *p;) {
+        const char *end = strchr(p, ',');
+        size_t n = end ? (size_t)(end - p) : strlen(p);
+        if (n == len && memcmp(p, name, len) == 0)
+            return true;
+        if (!end) break;
+        p = end + 1;
+    }
+    return false;
+}
+
+// --- Comparators (each counts its calls per thread) ---
+
+static _Thread_local uint64_t ncmp;
+static atomic_uint_fast64_t thread_cmps;  // calls made by worker threads
+
+static void flush_cmps(void) {
+    atomic_fetch_add(&thread_cmps, ncmp);
+    ncmp = 0;
+}
+
+static int cmp_ptr(const void *a, const void *b) {
+    ncmp++;
+    uintptr_t x = (uintptr_t)a, y = (uintptr_t)b;
+    return (x > y) - (x < y);
+}
+
+static int cmp_deref(const void *a, const void *b) {
+    ncmp++;
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Shared prefix then the key big-endian: memcmp order is key order and
+// every compare scans the prefix first, like string keys would.
+typedef struct Record {
+    unsigned char b[16];
+} Record;
+
+static int cmp_record(const void *a, const void *b) {
+    ncmp++;
+    return memcmp(a, b, sizeof(Record));
+}
+
+typedef enum CmpMode { CMP_PTR, CMP_DEREF, CMP_RECORD, CMP_MODES } CmpMode;
+
+static const char *const cmp_names[CMP_MODES] = { "ptr", "deref", "record" };
+static const heap_cmp_fn cmp_fns[CMP_MODES] = { cmp_ptr, cmp_deref, cmp_record };
+
+// --- Inputs ---
+
+typedef enum Dist { DIST_RANDOM, DIST_SORTED, DIST_REVERSE, DIST_DUPS, DISTS } Dist;
+
+static const char *const dist_names[DISTS] = { "random", "sorted", "reverse", "dups" };
+
+typedef struct Input {
+    size_t n;
+    uint64_t *keys;      // keys < 2^63, so ptr items (key + 1) are never NULL
+    Record *recs;        // backing store of CMP_RECORD items
+    void **items;        // items for the current comparator
+    void **scratch;      // copy for in-place sorts
+    uint64_t *kscratch;  // same for the by-value heaps
+} Input;
+
+static uint64_t rng_state = UINT64_C(0x9E3779B97F4A7C15);
+
+static uint64_t rng_next(void) {
+    uint64_t x = rng_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    rng_state = x;
+    return x * UINT64_C(0x2545F4914F6CDD1D);
+}
+
+static void fill_keys(Input *in, Dist d) {
+    for (size_t i = 0; i < in->n; i++) {
+        switch (d) {
+        case DIST_RANDOM:  in->keys[i] = rng_next() >> 1; break;
+        case DIST_SORTED:  in->keys[i] = i; break;
+        case DIST_REVERSE: in->keys[i] = in->n - i; break;
+        default:           in->keys[i] = rng_next() % BENCH_DUP_KEYS; break;
+        }
+    }
+}
+
+static void fill_items(Input *in, CmpMode mode) {
+    for (size_t i = 0; i < in->n; i++) {
+        uint64_t k = in->keys[i];
+        if (mode == CMP_PTR) {
+            in->items[i] = (void *)(uintptr_t)(k + 1);
+        } else if (mode == CMP_DEREF) {
+            in->items[i] = &in->keys[i];
+        } else {
+            memcpy(in->recs[i].b, "heap-rec", 8);
+            for (int j = 0; j < 8; j++)
+                in->recs[i].b[8 + j] = (unsigned char)(k >> (56 - 8 * j));
+            in->items[i] = &in->recs[i];
+        }
+    }
+}
+
+// --- Measurement ---
+// A span times one measured region. Comparator calls and cache misses
+// are deltas over the region; the perf counter (inherited by worker
+// threads) is only enabled inside spans.
+
+static int perf_fd = -1;
+
+static void perf_open(void) {
+#ifdef __linux__
+    struct perf_event_attr a;
+    memset(&a, 0, sizeof(a));
+    a.type = PERF_TYPE_HARDWARE;
+    a.size = sizeof(a);
+    a.config = PERF_COUNT_HW_CACHE_MISSES;
+    a.disabled = 1;
+    a.inherit = 1;
+    a.exclude_kernel = 1;
+    a.exclude_hv = 1;
+    perf_fd = (int)syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+#endif
+    if (perf_fd < 0)
+        fprintf(stderr, "heap_bench: perf counters unavailable, cache misses not reported\n");
+}
+
+static uint64_t perf_read(void) {
+    uint64_t v = 0;
+    if (perf_fd >= 0 && read(perf_fd, &v, sizeof(v)) != (ssize_t)sizeof(v))
+        v = 0;
+    return v;
+}
+
+static void perf_enable(bool on) {
+#ifdef __linux__
+    if (perf_fd >= 0)
+        ioctl(perf_fd, on ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE, 0);
+#else
+    (void)on;
+#endif
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+typedef struct Meter {
+    uint64_t ns, cmps, misses;
+} Meter;
+
+typedef struct Span {
+    uint64_t t0, c0, m0;
+} Span;
+
+static void span_begin(Span *s) {
+    s->c0 = ncmp + atomic_load(&thread_cmps);
+    s->m0 = perf_read();
+    perf_enable(true);
+    s->t0 = now_ns();
+}
+
+static void span_end(const Span *s, Meter *m) {
+    uint64_t t1 = now_ns();
+    perf_enable(false);
+    m->ns += t1 - s->t0;
+    m->cmps += ncmp + atomic_load(&thread_cmps) - s->c0;
+    m->misses += perf_read() - s->m0;
+}
+
+// Row context: what is being measured besides variant and op.
+typedef struct Run {
+    const Input *in;
+    const char *dist, *cmp;
+    heap_cmp_fn fn;      // NULL for inline variants
+    size_t reps;
+} Run;
+
+static void report(const Run *r, const char *variant, const char *op, const Meter *m) {
+    double ops = (double)r->in->n * (double)r->reps;
+    printf("%s,%s,%s,%s,%zu,%zu,%.2f,", variant, op, r->dist, r->fn ? r->cmp : "inline",
+           r->in->n, r->reps, (double)m->ns / ops);
+    if (r->fn) printf("%.2f", (double)m->cmps / ops);
+    putchar(',');
+    if (perf_fd >= 0) printf("%.3f", (double)m->misses / ops);
+    putchar('\n');
+    fflush(stdout);
+}
+
+// --- Heap variants ---
+
+typedef struct HeapVariant {
+    const char *name;
+    HeapConfig cfg;
+} HeapVariant;
+
+static const HeapVariant heap_variants[] = {
+    { "binary",  { .arity = 2 } },
+    { "4-ary",   { .arity = 4 } },
+    { "8-ary",   { .arity = 8 } },
+    { "blocked", { .layout = HEAP_LAYOUT_BLOCKED } },
+    { "lazy",    { .lazy_insert = true } },
+};
+
+// A filled heap, ready for extract or replace.
+static Heap *filled_heap(const HeapVariant *v, const Run *r) {
+    Heap *h = need(heap_create_ex(r->fn, r->in->n, &v->cfg));
+    if (heap_insert_many(h, r->in->items, r->in->n) < 0)
+        need(NULL);
+    heap_flush(h);
+    return h;
+}
+
+static void bench_heap(const HeapVariant *v, const Run *r) {
+    const Input *in = r->in;
+    size_t n = in->n;
+    Span s;
+    Meter m;
+
+    if (listed(opt.ops, "insert")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            Heap *h = need(heap_create_ex(r->fn, 0, &v->cfg));
+            span_begin(&s);
+            for (size_t i = 0; i < n; i++)
+                if (heap_insert(h, in->items[i]) < 0) need(NULL);
+            heap_flush(h);  // the lazy variant pays its deferred work here
+            span_end(&s, &m);
+            heap_destroy(h);
+        }
+        report(r, v->name, "insert", &m);
+    }
+    if (listed(opt.ops, "extract")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            Heap *h = filled_heap(v, r);
+            span_begin(&s);
+            for (size_t i = 0; i < n; i++)
+                sink ^= (uintptr_t)heap_extract(h);
+            span_end(&s, &m);
+            heap_destroy(h);
+        }
+        report(r, v->name, "extract", &m);
+    }
+    if (listed(opt.ops, "replace")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            Heap *h = filled_heap(v, r);
+            span_begin(&s);
+            for (size_t i = 0; i < n; i++)
+                sink ^= (uintptr_t)heap_replace(h, in->items[n - 1 - i]);
+            span_end(&s, &m);
+            heap_destroy(h);
+        }
+        report(r, v->name, "replace", &m);
+    }
+    if (listed(opt.ops, "build")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            Heap *h = need(heap_create_ex(r->fn, n, &v->cfg));
+            span_begin(&s);
+            if (heap_insert_many(h, in->items, n) < 0) need(NULL);
+            heap_flush(h);
+            span_end(&s, &m);
+            heap_destroy(h);
+        }
+        report(r, v->name, "build", &m);
+    }
+    if (listed(opt.ops, "sort") && strcmp(v->name, "binary") == 0) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            memcpy(in->scratch, in->items, n * sizeof(void *));
+            span_begin(&s);
+            heap_sort(in->scratch, n, r->fn);
+            span_end(&s, &m);
+        }
+        report(r, v->name, "sort", &m);
+    }
+}
+
+// Parallel build and sort (the other ops are the binary heap's).
+static void bench_parallel(const Run *r) {
+    const Input *in = r->in;
+    Span s;
+    Meter m;
+
+    if (listed(opt.ops, "build")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            span_begin(&s);
+            Heap *h = need(heap_build_parallel(in->items, in->n, r->fn, opt.threads));
+            span_end(&s, &m);
+            heap_destroy(h);
+        }
+        report(r, "parallel", "build", &m);
+    }
+    if (listed(opt.ops, "sort")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            memcpy(in->scratch, in->items, in->n * sizeof(void *));
+            span_begin(&s);
+            heap_sort_parallel(in->scratch, in->n, r->fn, opt.threads);
+            span_end(&s, &m);
+        }
+        report(r, "parallel", "sort", &m);
+    }
+}
+
+// --- ConcHeap: opt.threads threads each insert, then extract, n/threads ---
+
+typedef struct ConcTask {
+    ConcHeap *q;
+    void **items;
+    size_t n;
+    uintptr_t acc;        // extract results, folded into sink after join
+} ConcTask;
+
+static void *conc_insert_task(void *arg) {
+    ConcTask *t = arg;
+    for (size_t i = 0; i < t->n; i++)
+        if (conc_heap_insert(t->q, t->items[i]) < 0) need(NULL);
+    flush_cmps();
+    return NULL;
+}
+
+static void *conc_extract_task(void *arg) {
+    ConcTask *t = arg;
+    uintptr_t acc = 0;
+    for (size_t i = 0; i < t->n; i++)
+        acc ^= (uintptr_t)conc_heap_extract(t->q);
+    t->acc = acc;
+    flush_cmps();
+    return NULL;
+}
+
+static void run_tasks(void *(*fn)(void *), ConcTask *tasks, unsigned nthreads) {
+    pthread_t tid[BENCH_MAX_THR];
+    bool started[BENCH_MAX_THR];
+    for (unsigned t = 1; t < nthreads; t++)
+        started[t] = pthread_create(&tid[t], NULL, fn, &tasks[t]) == 0;
+    fn(&tasks[0]);
+    for (unsigned t = 1; t < nthreads; t++) {
+        if (started[t]) pthread_join(tid[t], NULL);
+        else fn(&tasks[t]);
+    }
+}
+
+static void bench_conc(const Run *r) {
+    bool ins = listed(opt.ops, "insert"), ext = listed(opt.ops, "extract");
+    if (!ins && !ext) return;
+    const Input *in = r->in;
+    unsigned nt = opt.threads;
+    ConcTask tasks[BENCH_MAX_THR];
+    Meter mi = { 0 }, me = { 0 };
+    Span s;
+
+    for (size_t k = 0; k < r->reps; k++) {
+        ConcHeap *q = need(conc_heap_create(r->fn, 0, CONC_HEAP_RELAXED));
+        for (unsigned t = 0; t < nt; t++) {
+            size_t lo = in->n * t / nt, hi = in->n * (t + 1) / nt;
+            tasks[t] = (ConcTask){ q, in->items + lo, hi - lo, 0 };
+        }
+        span_begin(&s);
+        run_tasks(conc_insert_task, tasks, nt);
+        span_end(&s, &mi);
+        span_begin(&s);
+        run_tasks(conc_extract_task, tasks, nt);
+        span_end(&s, &me);
+        for (unsigned t = 0; t < nt; t++)
+            sink ^= tasks[t].acc;
+        conc_heap_destroy(q);
+    }
+    if (ins) report(r, "conc", "insert", &mi);
+    if (ext) report(r, "conc", "extract", &me);
+}
+
+// --- Comparator-free variants ---
+
+static void bench_template(const Run *r) {
+    const Input *in = r->in;
+    size_t n = in->n;
+    u64_heap h;
+    Span s;
+    Meter m;
+
+    if (listed(opt.ops, "insert")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            u64_heap_init(&h);
+            span_begin(&s);
+            for (size_t i = 0; i < n; i++)
+                if (u64_heap_insert(&h, in->keys[i]) < 0) need(NULL);
+            span_end(&s, &m);
+            u64_heap_free(&h);
+        }
+        report(r, "template", "insert", &m);
+    }
+    if (listed(opt.ops, "extract")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            u64_heap_init(&h);
+            if (u64_heap_build(&h, in->keys, n) < 0) need(NULL);
+            uint64_t v, acc = 0;
+            span_begin(&s);
+            for (size_t i = 0; i < n; i++)
+                if (u64_heap_extract(&h, &v)) acc ^= v;
+            span_end(&s, &m);
+            sink ^= (uintptr_t)acc;
+            u64_heap_free(&h);
+        }
+        report(r, "template", "extract", &m);
+    }
+    if (listed(opt.ops, "replace")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            u64_heap_init(&h);
+            if (u64_heap_build(&h, in->keys, n) < 0) need(NULL);
+            uint64_t v, acc = 0;
+            span_begin(&s);
+            for (size_t i = 0; i < n; i++)
+                if (u64_heap_replace(&h, in->keys[n - 1 - i], &v)) acc ^= v;
+            span_end(&s, &m);
+            sink ^= (uintptr_t)acc;
+            u64_heap_free(&h);
+        }
+        report(r, "template", "replace", &m);
+    }
+    if (listed(opt.ops, "build")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            u64_heap_init(&h);
+            if (u64_heap_reserve(&h, n) < 0) need(NULL);
+            span_begin(&s);
+            if (u64_heap_build(&h, in->keys, n) < 0) need(NULL);
+            span_end(&s, &m);
+            u64_heap_free(&h);
+        }
+        report(r, "template", "build", &m);
+    }
+    if (listed(opt.ops, "sort")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            memcpy(in->kscratch, in->keys, n * sizeof(uint64_t));
+            span_begin(&s);
+            u64_heap_sort(in->kscratch, n);
+            span_end(&s, &m);
+        }
+        report(r, "template", "sort", &m);
+    }
+}
+
+static KeyedHeap *filled_keyed(const KeyedHeapConfig *cfg, const Input *in) {
+    KeyedHeap *h = need(keyed_heap_create_ex(in->n, cfg));
+    for (size_t i = 0; i < in->n; i++)
+        if (keyed_heap_insert(h, in->keys[i], NULL) < 0) need(NULL);
+    return h;
+}
+
+static void bench_keyed(const char *name, unsigned arity, const Run *r) {
+    const Input *in = r->in;
+    size_t n = in->n;
+    KeyedHeapConfig cfg = { .order = KEYED_HEAP_MAX, .arity = arity };
+    Span s;
+    Meter m;
+
+    if (listed(opt.ops, "insert")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            KeyedHeap *h = need(keyed_heap_create_ex(0, &cfg));
+            span_begin(&s);
+            for (size_t i = 0; i < n; i++)
+                if (keyed_heap_insert(h, in->keys[i], NULL) < 0) need(NULL);
+            span_end(&s, &m);
+            keyed_heap_destroy(h);
+        }
+        report(r, name, "insert", &m);
+    }
+    if (listed(opt.ops, "extract")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            KeyedHeap *h = filled_keyed(&cfg, in);
+            uint64_t key, acc = 0;
+            span_begin(&s);
+            for (size_t i = 0; i < n; i++)
+                if (keyed_heap_extract(h, &key, NULL)) acc ^= key;
+            span_end(&s, &m);
+            sink ^= (uintptr_t)acc;
+            keyed_heap_destroy(h);
+        }
+        report(r, name, "extract", &m);
+    }
+    if (listed(opt.ops, "replace")) {
+        m = (Meter){ 0 };
+        for (size_t k = 0; k < r->reps; k++) {
+            KeyedHeap *h = filled_keyed(&cfg, in);
+            uint64_t key, acc = 0;
+            span_begin(&s);
+            for (size_t i = 0; i < n; i++)
+                if (keyed_heap_replace(h, in->keys[n - 1 - i], NULL, &key, NULL)) acc ^= key;
+            span_end(&s, &m);
+            sink ^= (uintptr_t)acc;
+            keyed_heap_destroy(h);
+        }
+        report(r, name, "replace", &m);
+    }
+}
+
+// --- Driver ---
+
+static void bench_size(size_t n) {
+    Input in = { .n = n };
+    in.keys = need(malloc(n * sizeof(uint64_t)));
+    in.items = need(malloc(n * sizeof(void *)));
+    in.scratch = need(malloc(n * sizeof(void *)));
+    in.kscratch = need(malloc(n * sizeof(uint64_t)));
+    in.recs = need(malloc(n * sizeof(Record)));
+    size_t reps = n >= BENCH_MIN_OPS ? 1 : BENCH_MIN_OPS / n;
+
+    for (Dist d = 0; d < DISTS; d++) {
+        fill_keys(&in, d);
+        for (CmpMode c = 0; c < CMP_MODES; c++) {
+            fill_items(&in, c);
+            Run r = { &in, dist_names[d], cmp_names[c], cmp_fns[c], reps };
+            for (size_t v = 0; v < sizeof(heap_variants) / sizeof(heap_variants[0]); v++)
+                if (listed(opt.variants, heap_variants[v].name))
+                    bench_heap(&heap_variants[v], &r);
+            if (listed(opt.variants, "parallel"))
+                bench_parallel(&r);
+            if (listed(opt.variants, "conc"))
+                bench_conc(&r);
+        }
+        Run r = { &in, dist_names[d], NULL, NULL, reps };
+        if (listed(opt.variants, "template"))
+            bench_template(&r);
+        if (listed(opt.variants, "keyed"))
+            bench_keyed("keyed", 2, &r);
+        if (listed(opt.variants, "keyed4"))
+            bench_keyed("keyed4", 4, &r);
+    }
+    free(in.keys);
+    free(in.items);
+    free(in.scratch);
+    free(in.kscratch);
+    free(in.recs);
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "usage: heap_bench [-n max_n] [-t threads] [-v variant,...] [-o op,...]\n"
+            "  variants: binary 4-ary 8-ary blocked lazy parallel conc template keyed keyed4\n"
+            "  ops:      insert extract replace build sort\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    int c;
+    while ((c = getopt(argc, argv, "n:t:v:o:h")) != -1) {
+        switch (c) {
+        case 'n': opt.max_n = strtoull(optarg, NULL, 10); break;
+        case 't': opt.threads = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'v': opt.variants = optarg; break;
+        case 'o': opt.ops = optarg; break;
+        default:  usage();
+        }
+    }
+    if (opt.max_n < 1000) usage();
+    if (opt.threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        opt.threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if (opt.threads > BENCH_MAX_THR) opt.threads = BENCH_MAX_THR;
+
+    perf_open();
+    printf("variant,op,dist,cmp,n,reps,ns_per_op,cmps_per_op,cache_misses_per_op\n");
+    for (size_t n = 1000; n <= opt.max_n; n *= 10) {
+        bench_size(n);
+        if (n > opt.max_n / 10 && n != opt.max_n)
+            bench_size(opt.max_n);  // odd maximum: measure it too
+        if (n > SIZE_MAX / 10) break;
+    }
+    return 0;
+}
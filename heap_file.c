@@ -0,0 +1,345 @@
+// Persistent heap in a memory-mapped file
+// -----------------------------------------------
+// - File = 64-byte header + d-ary heap array of fixed-size elements + one
+//   spare element slot past the array
+// - Mapped MAP_SHARED: every operation works on the page cache directly,
+//   reopening is one mmap plus a header check, no rebuild
+// - Checkpoints: msync the mapping, then clear the header's dirty flag
+//   (set by the first modification after a checkpoint) and msync again
+// - Sifts move a hole; the element in flight lives in the spare slot and
+//   the header journals the hole and the size the operation ends with.
+//   Each step is one element copy followed by one 8-byte header store, so
+//   a process killed at any point leaves a file where "array with the
+//   spare put into the hole" is the heap before or after the operation
+// - A file opened dirty replays the journal and is re-heapified once, so
+//   a crash costs one O(n) pass instead of a rebuild from the source data
+//
+// The file is in native byte order; the magic number doubles as a byte
+// order check.
+//
+// -----------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "heap_file.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define HEAP_FILE_MAGIC   UINT64_C(0x314c494650414548)  // "HEAPFIL1" in little-endian
+#define HEAP_FILE_VERSION 1
+#define HEAP_FILE_MIN_CAP 64
+
+typedef struct HeapFileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t arity;
+    uint64_t elem_size;
+    uint64_t size;
+    uint64_t capacity;
+    uint32_t dirty;       // modified since the last checkpoint
+    uint32_t reserved;
+    uint64_t jsize;       // size the journaled operation ends with
+    uint64_t jhole;       // hole index + 1 whose element is in the spare, 0 if none
+} HeapFileHeader;
+
+_Static_assert(sizeof(HeapFileHeader) == 64, "header must stay one cache line");
+
+struct HeapFile {
+    HeapFileHeader *hdr;  // start of the mapping
+    unsigned char *data;  // heap array, right after the header
+    size_t map_bytes;
+    int fd;
+    size_t elem;          // element size
+    unsigned shift;       // log2(arity)
+    heap_cmp_fn cmp;
+    unsigned char *spare; // slot past the array, holds the moving element
+};
+
+// --- Utility helpers ---
+
+static inline unsigned char *at(const HeapFile *f, size_t i) {
+    return f->data + i * f->elem;
+}
+
+static inline size_t parent(const HeapFile *f, size_t i) { return (i - 1) >> f->shift; }
+static inline size_t child(const HeapFile *f, size_t i)  { return (i << f->shift) + 1; }
+
+// Header, capacity elements and the spare slot.
+static inline size_t file_bytes(size_t elem, size_t capacity) {
+    return sizeof(HeapFileHeader) + elem * (capacity + 1);
+}
+
+// Largest capacity whose file size fits in size_t.
+static inline size_t max_capacity(size_t elem) {
+    size_t n = (SIZE_MAX - sizeof(HeapFileHeader)) / elem;
+    return n > 0 ? n - 1 : 0;
+}
+
+// Mark the file dirty before the first write after a checkpoint. The
+// header is forced out right away so that after an OS crash a file with
+// half-written array pages can never look clean; that is one synchronous
+// page write per checkpoint interval.
+static inline void touch(HeapFile *f) {
+    if (f->hdr->dirty) return;
+    f->hdr->dirty = 1;
+    (void)msync(f->hdr, sizeof(HeapFileHeader), MS_SYNC);
+}
+
+// Map `bytes` of the file, replacing any previous mapping.
+static int map_file(HeapFile *f, size_t bytes) {
+    void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, f->fd, 0);
+    if (p == MAP_FAILED) return -1;
+    if (f->hdr) munmap(f->hdr, f->map_bytes);
+    f->hdr = p;
+    f->data = (unsigned char *)p + sizeof(HeapFileHeader);
+    f->spare = (unsigned char *)p + bytes - f->elem;
+    f->map_bytes = bytes;
+    return 0;
+}
+
+// --- Journal ---
+// The fences keep the compiler from moving element copies across the
+// header stores; a killed process has executed every store before the
+// point where it stopped, in program order.
+
+// Start an operation: the spare (already written) belongs at `hole`, and
+// the heap will have `size` elements.
+static inline void journal_begin(HeapFile *f, size_t hole, size_t size) {
+    atomic_signal_fence(memory_order_seq_cst);
+    f->hdr->jsize = size;
+    atomic_signal_fence(memory_order_seq_cst);
+    f->hdr->jhole = hole + 1;
+    atomic_signal_fence(memory_order_seq_cst);
+}
+
+static inline void journal_move(HeapFile *f, size_t hole) {
+    atomic_signal_fence(memory_order_seq_cst);
+    f->hdr->jhole = hole + 1;
+    atomic_signal_fence(memory_order_seq_cst);
+}
+
+// The array is consistent again: publish the size, then drop the record.
+static inline void journal_end(HeapFile *f) {
+    atomic_signal_fence(memory_order_seq_cst);
+    f->hdr->size = f->hdr->jsize;
+    atomic_signal_fence(memory_order_seq_cst);
+    f->hdr->jhole = 0;
+    atomic_signal_fence(memory_order_seq_cst);
+}
+
+// --- Heapify helpers ---
+// Sifts start with the moving element in the spare and the journal's hole
+// at i. They shift the others into the hole, one element copy and one
+// journal store per level, and end with the spare copied into the hole.
+
+static void sift_up(HeapFile *f, size_t i) {
+    while (i > 0) {
+        size_t p = parent(f, i);
+        if (f->cmp(f->spare, at(f, p)) <= 0)
+            break;
+        memcpy(at(f, i), at(f, p), f->elem);
+        journal_move(f, p);
+        i = p;
+    }
+    memcpy(at(f, i), f->spare, f->elem);
+}
+
+static void sift_down(HeapFile *f, size_t i, size_t n) {
+    size_t arity = (size_t)1 << f->shift;
+    for (;;) {
+        size_t c = child(f, i);
+        if (c >= n)
+            break;
+        size_t end = c + arity < n ? c + arity : n, best = c;
+        for (c++; c < end; c++)
+            if (f->cmp(at(f, c), at(f, best)) > 0)
+                best = c;
+        if (f->cmp(at(f, best), f->spare) <= 0)
+            break;
+        memcpy(at(f, i), at(f, best), f->elem);
+        journal_move(f, best);
+        i = best;
+    }
+    memcpy(at(f, i), f->spare, f->elem);
+}
+
+static HeapFile *file_new(int fd, size_t elem, heap_cmp_fn cmp) {
+    HeapFile *f = calloc(1, sizeof(*f));
+    if (!f) return NULL;
+    f->fd = fd;
+    f->elem = elem;
+    f->cmp = cmp;
+    return f;
+}
+
+static void file_free(HeapFile *f) {
+    if (f->hdr) munmap(f->hdr, f->map_bytes);
+    close(f->fd);
+    free(f);
+}
+
+// -----------------------------------------------------------
+// Public API
+// -----------------------------------------------------------
+
+HeapFile *heap_file_create(const char *path, size_t elem_size, unsigned arity,
+                           heap_cmp_fn cmp) {
+    if (arity == 0) arity = 2;
+    if (!path || !cmp || elem_size == 0 || (arity != 2 && arity != 4 && arity != 8)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return NULL;
+    HeapFile *f = file_new(fd, elem_size, cmp);
+    if (!f) { close(fd); errno = ENOMEM; return NULL; }
+
+    size_t bytes = file_bytes(elem_size, HEAP_FILE_MIN_CAP);
+    if (ftruncate(fd, (off_t)bytes) < 0 || map_file(f, bytes) < 0) {
+        int err = errno;
+        file_free(f);
+        errno = err;
+        return NULL;
+    }
+    f->shift = arity == 2 ? 1 : arity == 4 ? 2 : 3;
+    *f->hdr = (HeapFileHeader){
+        .magic = HEAP_FILE_MAGIC, .version = HEAP_FILE_VERSION, .arity = arity,
+        .elem_size = elem_size, .size = 0, .capacity = HEAP_FILE_MIN_CAP, .dirty = 1,
+    };
+    return f;
+}
+
+HeapFile *heap_file_open(const char *path, heap_cmp_fn cmp) {
+    if (!path || !cmp) { errno = EINVAL; return NULL; }
+    int fd = open(path, O_RDWR);
+    if (fd < 0) return NULL;
+
+    HeapFileHeader h;
+    struct stat st;
+    if (fstat(fd, &st) < 0) { close(fd); return NULL; }
+    if (pread(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) ||
+        h.magic != HEAP_FILE_MAGIC || h.version != HEAP_FILE_VERSION ||
+        (h.arity != 2 && h.arity != 4 && h.arity != 8) || h.elem_size == 0 ||
+        h.size > h.capacity ||
+        h.capacity > max_capacity(h.elem_size) ||
+        (uint64_t)st.st_size < file_bytes(h.elem_size, h.capacity) ||
+        (h.jhole && (h.jhole > h.jsize || h.jsize > h.capacity))) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    HeapFile *f = file_new(fd, h.elem_size, cmp);
+    if (!f) { close(fd); errno = ENOMEM; return NULL; }
+    if (map_file(f, file_bytes(h.elem_size, h.capacity)) < 0) {
+        int err = errno;
+        file_free(f);
+        errno = err;
+        return NULL;
+    }
+    f->shift = h.arity == 2 ? 1 : h.arity == 4 ? 2 : 3;
+
+    // Killed mid-operation: put the spare into the hole and take the size
+    // the operation ends with. Its sift may be unfinished, and after an OS
+    // crash pages may be from different times, so restore heap order too.
+    if (f->hdr->jhole) {
+        memcpy(at(f, f->hdr->jhole - 1), f->spare, f->elem);
+        journal_end(f);
+    }
+    size_t n = f->hdr->size;
+    if (f->hdr->dirty && n > 1) {
+        for (size_t i = parent(f, n - 1) + 1; i-- > 0;) {
+            memcpy(f->spare, at(f, i), f->elem);
+            journal_begin(f, i, n);
+            sift_down(f, i, n);
+            journal_end(f);
+        }
+    }
+    return f;
+}
+
+int heap_file_sync(HeapFile *f) {
+    if (!f) return -1;
+    if (!f->hdr->dirty) return 0;
+    if (msync(f->hdr, f->map_bytes, MS_SYNC) < 0) return -1;
+    f->hdr->dirty = 0;
+    return msync(f->hdr, sizeof(HeapFileHeader), MS_SYNC);
+}
+
+int heap_file_close(HeapFile *f) {
+    if (!f) return 0;
+    int rc = heap_file_sync(f);
+    file_free(f);
+    return rc;
+}
+
+int heap_file_reserve(HeapFile *f, size_t n) {
+    if (f->hdr->capacity >= n) return 0;
+    if (n > max_capacity(f->elem)) return HEAP_ERR_NOMEM;
+    size_t bytes = file_bytes(f->elem, n);
+    if (ftruncate(f->fd, (off_t)bytes) < 0 || map_file(f, bytes) < 0)
+        return HEAP_ERR_NOMEM;
+    touch(f);
+    f->hdr->capacity = n;
+    return 0;
+}
+
+int heap_file_insert(HeapFile *f, const void *elem) {
+    size_t n = f->hdr->size;
+    if (n == f->hdr->capacity) {
+        int rc = heap_file_reserve(f, n * 2);
+        if (rc < 0)
+            return rc;
+    }
+    touch(f);
+    memcpy(f->spare, elem, f->elem);
+    journal_begin(f, n, n + 1);
+    sift_up(f, n);
+    journal_end(f);
+    return 0;
+}
+
+const void *heap_file_peek(const HeapFile *f) {
+    return (f && f->hdr->size > 0) ? f->data : NULL;
+}
+
+bool heap_file_extract(HeapFile *f, void *out) {
+    if (!f || f->hdr->size == 0) return false;
+    touch(f);
+    if (out) memcpy(out, f->data, f->elem);
+    size_t n = f->hdr->size - 1;
+    if (n == 0) {
+        f->hdr->size = 0;
+        return true;
+    }
+    // The last element moves into the root's hole; the size drops with the
+    // journal's commit, so array[n] is outside the heap from then on.
+    memcpy(f->spare, at(f, n), f->elem);
+    journal_begin(f, 0, n);
+    sift_down(f, 0, n);
+    journal_end(f);
+    return true;
+}
+
+size_t heap_file_size(const HeapFile *f) {
+    return f ? f->hdr->size : 0;
+}
+
+size_t heap_file_elem_size(const HeapFile *f) {
+    return f ? f->elem : 0;
+}
+
+bool heap_file_validate(const HeapFile *f) {
+    if (!f) return false;
+    for (size_t i = 1; i < f->hdr->size; i++)
+        if (f->cmp(at(f, i), at(f, parent(f, i))) > 0)
+            return false;
+    return true;
+}
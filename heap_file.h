@@ -0,0 +1,106 @@
+#ifndef HEAP_FILE_H
+#define HEAP_FILE_H
+
+#include <stddef.h> // size_t
+#include <stdbool.h>
+#include "heap.h"   // heap_cmp_fn, error codes
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct HeapFile HeapFile;
+
+/**
+ * @brief Create (or truncate) a persistent heap of by-value elements.
+ *
+ * The file holds a 64-byte header (size, capacity, element size, arity,
+ * a one-element journal) followed by the heap array and one spare slot,
+ * and is mapped shared, so the heap lives in the page cache and survives
+ * the process. The file grows on demand.
+ *
+ * @param path File to create; an existing file is truncated.
+ * @param elem_size Size of one element in bytes (> 0).
+ * @param arity Children per node: 2 (default when 0), 4 or 8.
+ * @param cmp Comparator over element pointers. Must return positive if a > b.
+ * @return Pointer to HeapFile or NULL on failure (errno is set).
+ */
+HeapFile *heap_file_create(const char *path, size_t elem_size, unsigned arity,
+                           heap_cmp_fn cmp);
+
+/**
+ * @brief Reopen a heap file in O(1).
+ *
+ * Maps the file and checks its header; the array is used as is. If the
+ * file was not checkpointed after its last change (the process died
+ * before heap_file_sync()/heap_file_close()), the journal is replayed and
+ * the array re-heapified once, O(n).
+ *
+ * If only the process died, every completed operation is kept and an
+ * interrupted insert or extract has happened either fully or not at all.
+ * If the operating system crashed, pages written since the last
+ * checkpoint may have reached the disk in any order, so elements changed
+ * since then may be lost or duplicated; the result is still a valid heap.
+ *
+ * @param cmp The comparator the file was built with (not stored in it).
+ * @return Pointer to HeapFile or NULL on failure (errno is set; EINVAL
+ *         for a file that is not a heap file of this build's byte order).
+ */
+HeapFile *heap_file_open(const char *path, heap_cmp_fn cmp);
+
+/**
+ * @brief Checkpoint, unmap and close.
+ * @return 0 on success, -1 if the checkpoint failed (resources are freed
+ *         either way).
+ */
+int heap_file_close(HeapFile *f);
+
+/**
+ * @brief Checkpoint: msync the array, then mark the file clean.
+ * @return 0 on success, -1 on I/O error (errno is set).
+ */
+int heap_file_sync(HeapFile *f);
+
+/**
+ * @brief Insert a copy of the element at `elem`.
+ * @return 0 on success, HEAP_ERR_NOMEM if the file could not be grown.
+ */
+int heap_file_insert(HeapFile *f, const void *elem);
+
+/**
+ * @brief Pointer to the root element inside the mapping, or NULL if empty.
+ *
+ * Valid until the next modification of the heap.
+ */
+const void *heap_file_peek(const HeapFile *f);
+
+/**
+ * @brief Copy the root element into out (may be NULL) and remove it.
+ * @return false if the heap is empty.
+ */
+bool heap_file_extract(HeapFile *f, void *out);
+
+/**
+ * @brief Ensure room for n elements (grows the file).
+ */
+int heap_file_reserve(HeapFile *f, size_t n);
+
+/**
+ * @brief Number of elements in heap.
+ */
+size_t heap_file_size(const HeapFile *f);
+
+/**
+ * @brief Element size the file was created with.
+ */
+size_t heap_file_elem_size(const HeapFile *f);
+
+/**
+ * @brief Check heap validity (for debugging).
+ */
+bool heap_file_validate(const HeapFile *f);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
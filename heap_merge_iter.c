@@ -0,0 +1,116 @@
+// K-way merge of sorted streams with a loser tree
+// -----------------------------------------------
+// - Internal node p (1 <= p < k) stores the loser of the match played
+//   there; node 0 stores the overall winner. Leaf of source i is k + i,
+//   children of p are 2p and 2p + 1, for any k
+// - After the winner's source advances, only its leaf-to-root path is
+//   replayed: one comparison per level against the stored losers.
+//   A sift in a heap of stream heads compares against both children
+// - Exhausted sources lose every match, so the tree never changes shape
+//
+// -----------------------------------------------
+
+#include "heap_merge_iter.h"
+#include <stdlib.h>
+
+struct HeapMergeIter {
+    HeapSource *src;
+    void **head;          // current item of each source
+    bool *live;           // source still has `head`
+    size_t *tree;         // tree[0] = winner, tree[1..k) = losers
+    size_t k;
+    heap_cmp_fn cmp;
+};
+
+// True if source a's head goes out before source b's. Ties go to the lower
+// source index, which makes the merge stable.
+static inline bool beats(const HeapMergeIter *it, size_t a, size_t b) {
+    if (!it->live[b]) return true;
+    if (!it->live[a]) return false;
+    int c = it->cmp(it->head[a], it->head[b]);
+    return c < 0 || (c == 0 && a < b);
+}
+
+static void build(HeapMergeIter *it, size_t *win) {
+    size_t k = it->k;
+    for (size_t i = 0; i < k; i++)
+        win[k + i] = i;
+    for (size_t p = k - 1; p >= 1; p--) {
+        size_t a = win[2 * p], b = win[2 * p + 1];
+        if (beats(it, a, b)) {
+            it->tree[p] = b;
+            win[p] = a;
+        } else {
+            it->tree[p] = a;
+            win[p] = b;
+        }
+    }
+    it->tree[0] = k > 1 ? win[1] : 0;
+}
+
+// Source s (the old winner) has a new head: replay its path to the root.
+static void replay(HeapMergeIter *it, size_t s) {
+    for (size_t p = (it->k + s) / 2; p >= 1; p /= 2) {
+        if (beats(it, it->tree[p], s)) {
+            size_t t = it->tree[p];
+            it->tree[p] = s;
+            s = t;
+        }
+    }
+    it->tree[0] = s;
+}
+
+// -----------------------------------------------------------
+// Public API
+// -----------------------------------------------------------
+
+HeapMergeIter *heap_merge_iter_create(const HeapSource *sources, size_t n,
+                                      heap_cmp_fn cmp) {
+    if (!cmp || (n > 0 && !sources)) return NULL;
+    HeapMergeIter *it = calloc(1, sizeof(*it));
+    if (!it) return NULL;
+    it->k = n;
+    it->cmp = cmp;
+    if (n == 0) return it;
+
+    it->src = malloc(n * sizeof(*it->src));
+    it->head = malloc(n * sizeof(*it->head));
+    it->live = malloc(n * sizeof(*it->live));
+    it->tree = malloc(n * sizeof(*it->tree));
+    size_t *win = malloc(2 * n * sizeof(*win));
+    if (!it->src || !it->head || !it->live || !it->tree || !win) {
+        free(win);
+        heap_merge_iter_destroy(it);
+        return NULL;
+    }
+    for (size_t i = 0; i < n; i++) {
+        it->src[i] = sources[i];
+        it->live[i] = sources[i].next(sources[i].ctx, &it->head[i]);
+    }
+    build(it, win);
+    free(win);
+    return it;
+}
+
+size_t heap_merge_iter_next(HeapMergeIter *it, void **out, size_t max) {
+    if (!it || it->k == 0) return 0;
+    size_t n = 0;
+    while (n < max) {
+        size_t w = it->tree[0];
+        if (!it->live[w])
+            break;  // the winner is exhausted, so every source is
+        out[n++] = it->head[w];
+        it->live[w] = it->src[w].next(it->src[w].ctx, &it->head[w]);
+        replay(it, w);
+    }
+    return n;
+}
+
+void heap_merge_iter_destroy(HeapMergeIter *it) {
+    if (!it) return;
+    free(it->src);
+    free(it->head);
+    free(it->live);
+    free(it->tree);
+    free(it);
+}
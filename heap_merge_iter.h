@@ -0,0 +1,58 @@
+#ifndef HEAP_MERGE_ITER_H
+#define HEAP_MERGE_ITER_H
+
+#include <stddef.h> // size_t
+#include <stdbool.h>
+#include "heap.h"   // heap_cmp_fn
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Pull the next item of a source stream.
+ * @return false once the stream is exhausted (it is not called again).
+ */
+typedef bool (*heap_source_fn)(void *ctx, void **out);
+
+/**
+ * @brief One sorted input stream of a merge.
+ */
+typedef struct HeapSource {
+    heap_source_fn next;
+    void *ctx;
+} HeapSource;
+
+typedef struct HeapMergeIter HeapMergeIter;
+
+/**
+ * @brief Create a k-way merge over sorted streams.
+ *
+ * Each source must yield items in ascending order per cmp; the merge
+ * yields all of them in ascending order, items comparing equal in source
+ * order. It uses a loser tree: exactly one comparison per level, where
+ * a sift in a heap of stream heads needs two (or, bottom-up, one plus a
+ * short climb). Pulls the first item of every source here.
+ *
+ * @param sources Array of n sources (copied).
+ * @param cmp Comparator function. Must return positive if a > b.
+ * @return Pointer to HeapMergeIter or NULL on failure.
+ */
+HeapMergeIter *heap_merge_iter_create(const HeapSource *sources, size_t n,
+                                      heap_cmp_fn cmp);
+
+/**
+ * @brief Write up to max merged items into out[].
+ * @return Number of items written; less than max only at the end.
+ */
+size_t heap_merge_iter_next(HeapMergeIter *it, void **out, size_t max);
+
+/**
+ * @brief Free the iterator (sources are not touched).
+ */
+void heap_merge_iter_destroy(HeapMergeIter *it);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,183 @@
+// Priority-ordered work-stealing scheduler built on Heap
+// -----------------------------------------------
+// - One local Heap per worker, each on its own cache line
+// - Owner push/pop take an uncontended spinlock (one atomic exchange);
+//   other workers only touch it while stealing
+// - An idle worker steals up to half of a victim's items, best first,
+//   so high-priority work migrates to where there is capacity
+//
+// Steals hold both the victim's and the thief's lock, always acquired in
+// worker-index order, so concurrent steals cannot deadlock and stolen
+// items are never in flight outside a heap.
+//
+// -----------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "heap_sched.h"
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define HEAP_SCHED_CACHE_LINE 64
+#define HEAP_SCHED_SPINS      64
+
+typedef struct Worker {
+    _Alignas(HEAP_SCHED_CACHE_LINE) atomic_bool busy; // spinlock
+    atomic_size_t size;   // mirror of heap_size(heap), read without the lock
+    Heap *heap;
+    uint64_t rng;         // victim selection; only the owner touches it
+} Worker;
+
+struct HeapSched {
+    Worker *workers;
+    size_t nworkers;
+};
+
+// --- Spinlock ---
+
+static inline void spin_lock(atomic_bool *l) {
+    for (;;) {
+        if (!atomic_exchange_explicit(l, true, memory_order_acquire))
+            return;
+        for (int i = 0; atomic_load_explicit(l, memory_order_relaxed); i++) {
+            if (i >= HEAP_SCHED_SPINS) {
+                sched_yield();
+                i = 0;
+            }
+        }
+    }
+}
+
+static inline void spin_unlock(atomic_bool *l) {
+    atomic_store_explicit(l, false, memory_order_release);
+}
+
+// --- Worker helpers ---
+
+static inline void publish_size(Worker *w) {
+    atomic_store_explicit(&w->size, heap_size(w->heap), memory_order_relaxed);
+}
+
+static inline size_t peek_size(const Worker *w) {
+    return atomic_load_explicit(&w->size, memory_order_relaxed);
+}
+
+static inline size_t rng_pick(Worker *w, size_t n) {
+    uint64_t x = w->rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    w->rng = x;
+    return (size_t)((x * UINT64_C(0x2545F4914F6CDD1D)) % n);
+}
+
+// -----------------------------------------------------------
+// Public API
+// -----------------------------------------------------------
+
+HeapSched *heap_sched_create(heap_cmp_fn cmp, size_t workers) {
+    if (!cmp || workers == 0) return NULL;
+
+    HeapSched *s = calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->workers = aligned_alloc(HEAP_SCHED_CACHE_LINE, workers * sizeof(Worker));
+    if (!s->workers) { free(s); return NULL; }
+
+    for (size_t i = 0; i < workers; i++) {
+        Worker *w = &s->workers[i];
+        w->heap = heap_create(cmp, 0);
+        if (!w->heap) {
+            s->nworkers = i;
+            heap_sched_destroy(s);
+            return NULL;
+        }
+        atomic_init(&w->busy, false);
+        atomic_init(&w->size, 0);
+        w->rng = UINT64_C(0x9E3779B97F4A7C15) * (i + 1);
+    }
+    s->nworkers = workers;
+    return s;
+}
+
+void heap_sched_destroy(HeapSched *s) {
+    if (!s) return;
+    for (size_t i = 0; i < s->nworkers; i++)
+        heap_destroy(s->workers[i].heap);
+    free(s->workers);
+    free(s);
+}
+
+int heap_sched_push(HeapSched *s, size_t worker, void *item) {
+    Worker *w = &s->workers[worker];
+    spin_lock(&w->busy);
+    int rc = heap_insert(w->heap, item);
+    publish_size(w);
+    spin_unlock(&w->busy);
+    return rc;
+}
+
+size_t heap_sched_steal(HeapSched *s, size_t thief, size_t victim, size_t max) {
+    if (thief == victim || max == 0 || peek_size(&s->workers[victim]) == 0)
+        return 0;
+    Worker *t = &s->workers[thief], *v = &s->workers[victim];
+    Worker *first = thief < victim ? t : v, *second = thief < victim ? v : t;
+
+    spin_lock(&first->busy);
+    spin_lock(&second->busy);
+
+    size_t n = (heap_size(v->heap) + 1) / 2;
+    if (n > max) n = max;
+    if (n > HEAP_SCHED_STEAL_MAX) n = HEAP_SCHED_STEAL_MAX;
+    // Reserve first so the items taken below always have a place to go.
+    if (n > 0 && heap_reserve(t->heap, heap_size(t->heap) + n) == 0) {
+        void *batch[HEAP_SCHED_STEAL_MAX];
+        n = heap_extract_many(v->heap, batch, n);
+        (void)heap_insert_many(t->heap, batch, n);
+        publish_size(v);
+        publish_size(t);
+    } else {
+        n = 0;
+    }
+
+    spin_unlock(&second->busy);
+    spin_unlock(&first->busy);
+    return n;
+}
+
+void *heap_sched_pop(HeapSched *s, size_t worker) {
+    Worker *w = &s->workers[worker];
+    spin_lock(&w->busy);
+    void *item = heap_extract(w->heap);
+    publish_size(w);
+    spin_unlock(&w->busy);
+    if (item || s->nworkers == 1)
+        return item;
+
+    // Prefer the fuller of two random victims, then sweep everyone.
+    size_t a = rng_pick(w, s->nworkers), b = rng_pick(w, s->nworkers);
+    size_t victim = peek_size(&s->workers[a]) >= peek_size(&s->workers[b]) ? a : b;
+    for (size_t k = 0; k <= s->nworkers; k++) {
+        if (k > 0)
+            victim = (worker + k) % s->nworkers;
+        if (heap_sched_steal(s, worker, victim, HEAP_SCHED_STEAL_MAX) == 0)
+            continue;
+        spin_lock(&w->busy);
+        item = heap_extract(w->heap);
+        publish_size(w);
+        spin_unlock(&w->busy);
+        if (item)
+            return item;
+    }
+    return NULL;
+}
+
+size_t heap_sched_size(const HeapSched *s) {
+    if (!s) return 0;
+    size_t n = 0;
+    for (size_t i = 0; i < s->nworkers; i++)
+        n += peek_size(&s->workers[i]);
+    return n;
+}
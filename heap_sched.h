@@ -0,0 +1,68 @@
+#ifndef HEAP_SCHED_H
+#define HEAP_SCHED_H
+
+#include <stddef.h> // size_t
+#include "heap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct HeapSched HeapSched;
+
+/** Most items moved by one steal. */
+#define HEAP_SCHED_STEAL_MAX 64
+
+/**
+ * @brief Create a priority-ordered work-stealing scheduler.
+ *
+ * Every worker owns a local Heap guarded by a spinlock that only the owner
+ * takes on its fast path; other workers take it briefly when stealing.
+ * A worker whose heap runs dry steals a batch of the highest-priority
+ * items from a busy victim.
+ *
+ * @param cmp Comparator function. Must return positive if a > b.
+ * @param workers Number of workers (ids 0 .. workers-1).
+ * @return Pointer to HeapSched or NULL on failure.
+ */
+HeapSched *heap_sched_create(heap_cmp_fn cmp, size_t workers);
+
+/**
+ * @brief Free the scheduler. No worker may be using it.
+ */
+void heap_sched_destroy(HeapSched *s);
+
+/**
+ * @brief Push an item onto a worker's local heap.
+ *
+ * Normally called by the owning worker, but any thread may push to any
+ * worker (e.g. to seed work).
+ * @return 0 on success, HEAP_ERR_NOMEM on allocation failure.
+ */
+int heap_sched_push(HeapSched *s, size_t worker, void *item);
+
+/**
+ * @brief Pop the best local item, stealing a batch when the local heap is
+ *        empty.
+ *
+ * @return An item, or NULL if no work was found in any heap.
+ */
+void *heap_sched_pop(HeapSched *s, size_t worker);
+
+/**
+ * @brief Move up to max of victim's best items into thief's heap.
+ *
+ * max is capped at half of the victim's items and HEAP_SCHED_STEAL_MAX.
+ * @return Number of items moved.
+ */
+size_t heap_sched_steal(HeapSched *s, size_t thief, size_t victim, size_t max);
+
+/**
+ * @brief Total queued items (a snapshot while workers are active).
+ */
+size_t heap_sched_size(const HeapSched *s);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
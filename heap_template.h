@@ -0,0 +1,166 @@
+#ifndef HEAP_TEMPLATE_H
+#define HEAP_TEMPLATE_H
+
+// Type-specialized heaps generated at compile time
+// -----------------------------------------------
+// HEAP_DEFINE(name, type, less_expr) emits a heap of `type` values stored
+// by value, with the comparison `less_expr` inlined into every sift.
+// Inside `less_expr` the two operands are named `a` and `b`; the
+// expression must be true when a orders before b. Like Heap, the root is
+// the greatest element, so name_sort() produces ascending order.
+//
+//     HEAP_DEFINE(int_heap, int, a < b)
+//
+//     int_heap h;
+//     int_heap_init(&h);
+//     int_heap_insert(&h, 42);
+//     int top;
+//     while (int_heap_extract(&h, &top)) ...
+//     int_heap_free(&h);
+//
+// Generated API (all static inline):
+//   name_init, name_free, name_reserve, name_size, name_clear,
+//   name_insert, name_peek, name_extract, name_replace,
+//   name_build (copy + Floyd), name_heapify (in place), name_sort
+//
+// -----------------------------------------------
+
+#include <stddef.h> // size_t
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HEAP_TEMPLATE_DEFAULT_CAP 16
+
+#define HEAP_DEFINE(name, type, less_expr)                                    \
+                                                                              \
+typedef struct name {                                                         \
+    type *data;                                                               \
+    size_t size;                                                              \
+    size_t capacity;                                                          \
+} name;                                                                       \
+                                                                              \
+static inline bool name##_less_(type a, type b) {                             \
+    (void)a; (void)b;                                                         \
+    return (less_expr);                                                       \
+}                                                                             \
+                                                                              \
+/* Bubble d[i] up; the moving value rides in a local. */                      \
+static inline void name##_sift_up_(type *d, size_t i) {                       \
+    type v = d[i];                                                            \
+    while (i > 0) {                                                           \
+        size_t p = (i - 1) / 2;                                               \
+        if (!name##_less_(d[p], v))                                           \
+            break;                                                            \
+        d[i] = d[p];                                                          \
+        i = p;                                                                \
+    }                                                                         \
+    d[i] = v;                                                                 \
+}                                                                             \
+                                                                              \
+/* Push d[i] down within d[0..n). */                                          \
+static inline void name##_sift_down_(type *d, size_t n, size_t i) {           \
+    type v = d[i];                                                            \
+    for (;;) {                                                                \
+        size_t c = 2 * i + 1;                                                 \
+        if (c >= n)                                                           \
+            break;                                                            \
+        if (c + 1 < n && name##_less_(d[c], d[c + 1]))                        \
+            c++;                                                              \
+        if (!name##_less_(v, d[c]))                                           \
+            break;                                                            \
+        d[i] = d[c];                                                          \
+        i = c;                                                                \
+    }                                                                         \
+    d[i] = v;                                                                 \
+}                                                                             \
+                                                                              \
+static inline void name##_init(name *h) {                                     \
+    h->data = NULL;                                                           \
+    h->size = h->capacity = 0;                                                \
+}                                                                             \
+                                                                              \
+static inline void name##_free(name *h) {                                     \
+    free(h->data);                                                            \
+    name##_init(h);                                                           \
+}                                                                             \
+                                                                              \
+static inline int name##_reserve(name *h, size_t n) {                         \
+    if (h->capacity >= n) return 0;                                           \
+    type *tmp = realloc(h->data, n * sizeof(type));                           \
+    if (!tmp) return -1;                                                      \
+    h->data = tmp;                                                            \
+    h->capacity = n;                                                          \
+    return 0;                                                                 \
+}                                                                             \
+                                                                              \
+static inline size_t name##_size(const name *h) { return h->size; }           \
+                                                                              \
+static inline void name##_clear(name *h) { h->size = 0; }                     \
+                                                                              \
+static inline int name##_insert(name *h, type v) {                            \
+    if (h->size == h->capacity) {                                             \
+        size_t cap = h->capacity ? h->capacity * 2                            \
+                                 : HEAP_TEMPLATE_DEFAULT_CAP;                 \
+        if (name##_reserve(h, cap) < 0)                                       \
+            return -1;                                                        \
+    }                                                                         \
+    h->data[h->size] = v;                                                     \
+    name##_sift_up_(h->data, h->size);                                        \
+    h->size++;                                                                \
+    return 0;                                                                 \
+}                                                                             \
+                                                                              \
+static inline bool name##_peek(const name *h, type *out) {                    \
+    if (h->size == 0) return false;                                           \
+    *out = h->data[0];                                                        \
+    return true;                                                              \
+}                                                                             \
+                                                                              \
+static inline bool name##_extract(name *h, type *out) {                       \
+    if (h->size == 0) return false;                                           \
+    *out = h->data[0];                                                        \
+    h->data[0] = h->data[--h->size];                                          \
+    if (h->size > 0)                                                          \
+        name##_sift_down_(h->data, h->size, 0);                               \
+    return true;                                                              \
+}                                                                             \
+                                                                              \
+/* Swap the root for v; returns false (and inserts nothing) if empty. */      \
+static inline bool name##_replace(name *h, type v, type *out) {               \
+    if (h->size == 0) return false;                                           \
+    *out = h->data[0];                                                        \
+    h->data[0] = v;                                                           \
+    name##_sift_down_(h->data, h->size, 0);                                   \
+    return true;                                                              \
+}                                                                             \
+                                                                              \
+/* Bottom-up heapify (Floyd's algorithm), O(n), in place. */                  \
+static inline void name##_heapify(type *arr, size_t n) {                      \
+    for (size_t i = n / 2; i-- > 0;)                                          \
+        name##_sift_down_(arr, n, i);                                         \
+}                                                                             \
+                                                                              \
+/* Replace contents of h with a copy of arr[0..n), heapified. */              \
+static inline int name##_build(name *h, const type *arr, size_t n) {          \
+    if (name##_reserve(h, n) < 0)                                             \
+        return -1;                                                            \
+    if (n > 0)                                                                \
+        memcpy(h->data, arr, n * sizeof(type));                               \
+    h->size = n;                                                              \
+    name##_heapify(h->data, n);                                               \
+    return 0;                                                                 \
+}                                                                             \
+                                                                              \
+/* In-place ascending heap sort, O(n log n), no allocation, not stable. */    \
+static inline void name##_sort(type *arr, size_t n) {                         \
+    name##_heapify(arr, n);                                                   \
+    for (size_t end = n; end-- > 1;) {                                        \
+        type top = arr[0];                                                    \
+        arr[0] = arr[end];                                                    \
+        arr[end] = top;                                                       \
+        name##_sift_down_(arr, end, 0);                                       \
+    }                                                                         \
+}
+
+#endif
@@ -0,0 +1,766 @@
+// Randomized tests for every heap variant against a reference model
+// -----------------------------------------------
+// - Heap: every HeapConfig (arity 2/4/8, blocked, lazy, stable and their
+//   mixes) under insert, insert_many, extract, replace, handles with
+//   update/remove, top_k and ordered iteration; heap_validate() throughout
+// - Bounded, static and cloned heaps; the sort/select helpers vs qsort
+// - KeyedHeap, RadixHeap, MinMaxHeap, PairingHeap, TimerWheel,
+//   HeapMergeIter, ConcHeap, HeapSched, ExtHeap and HeapFile
+//
+// The model is a plain array scanned linearly, so it is obviously right
+// and slow; sizes stay in the thousands.
+//
+// Build and run with `make check`; exits non-zero on the first failing
+// group after printing every failed check.
+//
+// -----------------------------------------------
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "heap.h"
+#include "keyed_heap.h"
+#include "radix_heap.h"
+#include "minmax_heap.h"
+#include "pairing_heap.h"
+#include "timer_wheel.h"
+#include "heap_merge_iter.h"
+#include "conc_heap.h"
+#include "heap_sched.h"
+#include "ext_heap.h"
+#include "heap_file.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static int failures;
+
+#define CHECK(cond)                                                           \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,  \
+                    #cond);                                                   \
+            failures++;                                                       \
+        }                                                                     \
+    } while (0)
+
+static uint64_t rng_state = 0x9e3779b97f4a7c15u;
+
+static uint64_t rng(void) {  // xorshift64*
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545f4914f6cdd1du;
+}
+
+static size_t below(size_t n) {
+    return (size_t)(rng() % n);
+}
+
+// --- Items ---
+// Keys are small so ties are common; id tells equal keys apart.
+
+typedef struct Item {
+    int key;
+    int id;
+} Item;
+
+static int item_cmp(const void *a, const void *b) {
+    int x = ((const Item *)a)->key, y = ((const Item *)b)->key;
+    return (x > y) - (x < y);
+}
+
+static int int_cmp(const void *a, const void *b) {
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int u64_cmp(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int ptr_key_cmp(const void *a, const void *b) {  // qsort over Item *
+    return item_cmp(*(void *const *)a, *(void *const *)b);
+}
+
+#define POOL 20000
+
+static Item pool[POOL];
+static int npool;
+
+static Item *new_item(int range) {
+    Item *it = &pool[npool % POOL];
+    it->key = (int)below((size_t)range);
+    it->id = npool++;
+    return it;
+}
+
+// Live items in insertion order (the stable mode's FIFO order).
+typedef struct Model {
+    Item *items[POOL];
+    size_t n;
+} Model;
+
+static void model_add(Model *m, Item *it) {
+    m->items[m->n++] = it;
+}
+
+// Index of the best item; ties go to the oldest.
+static size_t model_top(const Model *m) {
+    size_t best = 0;
+    for (size_t i = 1; i < m->n; i++)
+        if (m->items[i]->key > m->items[best]->key)
+            best = i;
+    return best;
+}
+
+static size_t model_find(const Model *m, const Item *it) {
+    for (size_t i = 0; i < m->n; i++)
+        if (m->items[i] == it)
+            return i;
+    return m->n;
+}
+
+static void model_del(Model *m, size_t i) {
+    memmove(&m->items[i], &m->items[i + 1], (m->n - i - 1) * sizeof(m->items[0]));
+    m->n--;
+}
+
+// Check an item the heap produced as its top against the model and drop
+// it there. Stable heaps must produce exactly the oldest best item.
+static void model_take(Model *m, const Item *it, bool stable) {
+    CHECK(m->n > 0 && it != NULL);
+    if (m->n == 0 || !it) return;
+    size_t t = model_top(m);
+    CHECK(it->key == m->items[t]->key);
+    if (stable) CHECK(it == m->items[t]);
+    size_t i = model_find(m, it);
+    CHECK(i < m->n);
+    if (i < m->n) model_del(m, i);
+}
+
+// --- Heap ---
+
+typedef struct HeapCase {
+    const char *name;
+    HeapConfig cfg;
+} HeapCase;
+
+static const HeapCase heap_cases[] = {
+    { "binary",       { 0 } },
+    { "4-ary",        { .arity = 4 } },
+    { "8-ary",        { .arity = 8 } },
+    { "blocked",      { .layout = HEAP_LAYOUT_BLOCKED } },
+    { "lazy",         { .lazy_insert = true } },
+    { "lazy-8-ary",   { .arity = 8, .lazy_insert = true } },
+    { "lazy-blocked", { .layout = HEAP_LAYOUT_BLOCKED, .lazy_insert = true } },
+    { "stable",       { .stable = true } },
+    { "stable-lazy",  { .arity = 4, .lazy_insert = true, .stable = true } },
+};
+
+#define HANDLES 512
+
+static Model model;
+
+// Forget the handle of an item that left the heap: its handle number may
+// be reused for a later insert.
+static void drop_handle(HeapHandle *hd, Item **hitem, size_t *nh, const Item *it) {
+    for (size_t k = 0; k < *nh; k++) {
+        if (hitem[k] == it) {
+            --*nh;
+            hd[k] = hd[*nh];
+            hitem[k] = hitem[*nh];
+            return;
+        }
+    }
+}
+
+// Random operations against the model. Handles are only used on
+// non-stable runs: an updated item has no defined FIFO position.
+static void heap_run(const HeapCase *hc, bool handles) {
+    Heap *h = heap_create_ex(item_cmp, 0, &hc->cfg);
+    CHECK(h != NULL);
+    if (!h) return;
+    bool stable = hc->cfg.stable && !handles;
+    HeapHandle hd[HANDLES];
+    Item *hitem[HANDLES];
+    size_t nh = 0;
+    model.n = 0;
+
+    for (int step = 0; step < 6000; step++) {
+        size_t op = below(16);
+        if (op < 6 || model.n == 0) {
+            Item *it = new_item(500);
+            if (handles && nh < HANDLES && below(2)) {
+                CHECK(heap_insert_handle(h, it, &hd[nh]) == 0);
+                hitem[nh++] = it;
+            } else {
+                CHECK(heap_insert(h, it) == 0);
+            }
+            model_add(&model, it);
+        } else if (op == 6) {
+            void *batch[40];
+            size_t n = below(40);
+            for (size_t k = 0; k < n; k++) {
+                batch[k] = new_item(500);
+                model_add(&model, batch[k]);
+            }
+            CHECK(heap_insert_many(h, batch, n) == 0);
+        } else if (op < 10) {
+            void *top = heap_peek(h);
+            void *got = heap_extract(h);
+            CHECK(top == got);
+            model_take(&model, got, stable);
+            drop_handle(hd, hitem, &nh, got);
+        } else if (op == 10) {
+            Item *it = new_item(500);
+            void *got = heap_replace(h, it);
+            model_take(&model, got, stable);
+            drop_handle(hd, hitem, &nh, got);
+            model_add(&model, it);
+        } else if (op < 14 && handles && nh > 0) {
+            // Change a live handle's key with no flush in between.
+            size_t k = below(nh);
+            Item *it = heap_handle_item(h, hd[k]);
+            CHECK(it == hitem[k]);
+            if (!it) continue;
+            it->key = (int)below(500);
+            if (op == 13) {
+                CHECK(heap_remove(h, hd[k]) == it);
+                model_del(&model, model_find(&model, it));
+                drop_handle(hd, hitem, &nh, it);
+            } else {
+                CHECK(heap_update(h, hd[k]) == 0);
+            }
+            CHECK(heap_validate(h));
+        } else if (op == 14) {
+            void *out[16];
+            size_t n = heap_top_k(h, out, 16);
+            CHECK(n == (model.n < 16 ? model.n : 16));
+            for (size_t k = 1; k < n; k++)
+                CHECK(item_cmp(out[k - 1], out[k]) >= 0);
+            if (n > 0) CHECK(item_cmp(out[0], heap_peek(h)) == 0);
+        } else {
+            CHECK(heap_validate(h));
+        }
+        CHECK(heap_size(h) == model.n);
+    }
+
+    HeapOrderedIter *it = heap_ordered_iter(h);
+    size_t walked = 0;
+    void *x, *prev = NULL;
+    while (heap_ordered_iter_next(it, &x)) {
+        if (prev) CHECK(item_cmp(prev, x) >= 0);
+        prev = x;
+        walked++;
+    }
+    heap_ordered_iter_destroy(it);
+    CHECK(walked == model.n);
+
+    Heap *c = heap_clone(h);
+    CHECK(c != NULL && heap_size(c) == model.n);
+    heap_flush(h);
+    CHECK(heap_validate(h));
+    while (model.n > 0) {
+        void *a = heap_extract(h), *b = heap_extract(c);
+        CHECK(a == b);
+        model_take(&model, a, stable);
+    }
+    CHECK(heap_extract(h) == NULL && heap_size(c) == 0);
+    heap_destroy(c);
+    heap_destroy(h);
+}
+
+// Lazy heap, a key change in the ordered prefix while an insert is still
+// pending: update must not let the tail climb past the changed node.
+static void heap_lazy_update(void) {
+    HeapConfig cfg = { .lazy_insert = true };
+    Heap *h = heap_create_ex(item_cmp, 0, &cfg);
+    Item v[5] = { { 10, 0 }, { 8, 1 }, { 1, 2 }, { 6, 3 }, { 5, 4 } };
+    HeapHandle hd[5];
+    for (int i = 0; i < 4; i++)
+        heap_insert_handle(h, &v[i], &hd[i]);
+    heap_flush(h);
+    heap_insert_handle(h, &v[4], &hd[4]);
+    v[1].key = 0;
+    CHECK(heap_update(h, hd[1]) == 0);
+    CHECK(heap_validate(h));
+    CHECK(heap_extract(h) == &v[0]);
+    CHECK(heap_extract(h) == &v[3]);
+    heap_destroy(h);
+}
+
+static void heap_bounded(void) {
+    Heap *h = heap_create_bounded(item_cmp, 50);
+    CHECK(h != NULL);
+    void *all[2000];
+    for (size_t i = 0; i < 2000; i++) {
+        all[i] = new_item(100000);
+        heap_offer(h, all[i]);
+    }
+    CHECK(heap_size(h) == 50);
+    CHECK(heap_insert(h, new_item(10)) == HEAP_ERR_FULL);
+    Heap *c = heap_clone(h);
+    CHECK(c != NULL && heap_insert(c, new_item(10)) == HEAP_ERR_FULL);
+    heap_destroy(c);
+    qsort(all, 2000, sizeof(void *), ptr_key_cmp);
+    for (size_t i = 50; i-- > 0;) {
+        Item *got = heap_extract(h);
+        CHECK(got && got->key == ((Item *)all[i])->key);
+    }
+    heap_destroy(h);
+}
+
+static void heap_static(void) {
+    HeapStorage storage;
+    void *buf[64];
+    Heap *h = heap_init_static(&storage, buf, 64, item_cmp);
+    CHECK(h != NULL);
+    model.n = 0;
+    for (int i = 0; i < 64; i++) {
+        Item *it = new_item(100);
+        CHECK(heap_insert(h, it) == 0);
+        model_add(&model, it);
+    }
+    CHECK(heap_insert(h, new_item(100)) == HEAP_ERR_FULL);
+    CHECK(heap_validate(h));
+
+    // The clone is malloc-backed and grows past the static capacity.
+    Heap *c = heap_clone(h);
+    CHECK(c != NULL && heap_size(c) == 64);
+    for (int i = 0; i < 200; i++)
+        CHECK(heap_insert(c, new_item(100)) == 0);
+    CHECK(heap_size(c) == 264 && heap_validate(c));
+    heap_destroy(c);
+
+    while (model.n > 0)
+        model_take(&model, heap_extract(h), false);
+    heap_destroy(h);
+}
+
+static void heap_sorts(void) {
+    enum { N = 3000 };
+    static void *a[N], *ref[N];
+    static int v[N], vref[N];
+    for (int round = 0; round < 4; round++) {
+        for (size_t i = 0; i < N; i++) {
+            ref[i] = a[i] = new_item(round & 1 ? 20 : 100000);
+            vref[i] = v[i] = (int)below(1000);
+        }
+        qsort(ref, N, sizeof(void *), ptr_key_cmp);
+        qsort(vref, N, sizeof(int), int_cmp);
+
+        heap_sort(a, N, item_cmp);
+        for (size_t i = 0; i < N; i++)
+            CHECK(item_cmp(a[i], ref[i]) == 0);
+        heap_sort_typed(v, N, sizeof(int), int_cmp);
+        CHECK(memcmp(v, vref, sizeof(v)) == 0);
+
+        for (size_t i = 0; i < N; i++)
+            a[i] = ref[N - 1 - i];
+        size_t k = 1 + below(N);
+        heap_partial_sort(a, N, k, item_cmp);
+        for (size_t i = 0; i < k; i++)
+            CHECK(item_cmp(a[i], ref[i]) == 0);
+        heap_select(a, N, k, item_cmp);
+        for (size_t i = 0; i < k; i++)
+            CHECK(item_cmp(a[i], ref[k - 1]) <= 0);
+
+        heap_sort_parallel(a, N, item_cmp, 1 + (unsigned)round);
+        for (size_t i = 0; i < N; i++)
+            CHECK(item_cmp(a[i], ref[i]) == 0);
+
+        Heap *h = heap_build_parallel(a, N, item_cmp, 1 + (unsigned)round);
+        CHECK(h && heap_validate(h));
+        static void *out[N];
+        CHECK(heap_drain_sorted(h, out) == N);
+        for (size_t i = 0; i < N; i++)
+            CHECK(item_cmp(out[i], ref[i]) == 0);
+        heap_destroy(h);
+    }
+}
+
+static void test_heap(void) {
+    for (size_t i = 0; i < sizeof(heap_cases) / sizeof(heap_cases[0]); i++) {
+        heap_run(&heap_cases[i], false);
+        heap_run(&heap_cases[i], true);
+    }
+    heap_lazy_update();
+    heap_bounded();
+    heap_static();
+    heap_sorts();
+}
+
+// --- KeyedHeap ---
+
+static void test_keyed(void) {
+    static const KeyedHeapConfig cfgs[] = {
+        { .order = KEYED_HEAP_MAX },
+        { .order = KEYED_HEAP_MIN, .arity = 4 },
+        { .order = KEYED_HEAP_MAX, .arity = 8 },
+        { .order = KEYED_HEAP_MIN, .stable = true },
+        { .order = KEYED_HEAP_MAX, .arity = 4, .stable = true },
+        { .order = KEYED_HEAP_MIN, .arity = 8, .stable = true },
+    };
+    enum { N = 8000 };
+    static uint64_t keys[N];
+    static bool live[N];
+    for (size_t c = 0; c < sizeof(cfgs) / sizeof(cfgs[0]); c++) {
+        bool min = cfgs[c].order == KEYED_HEAP_MIN;
+        KeyedHeap *h = keyed_heap_create_ex(0, &cfgs[c]);
+        CHECK(h != NULL);
+        size_t n = 0, nlive = 0;
+        for (size_t step = 0; step < N; step++) {
+            // Full-width keys with plenty of ties.
+            uint64_t key = keyed_heap_key_from_double((double)below(50) - 25.0);
+            if (below(3) || nlive == 0) {
+                keys[n] = key;
+                live[n] = true;
+                CHECK(keyed_heap_insert(h, keys[n], &keys[n]) == 0);
+                n++;
+                nlive++;
+            } else {
+                // Payloads point into keys[], so extracted slots stay put.
+                size_t best = n;
+                for (size_t i = 0; i < n; i++)
+                    if (live[i] && (best == n || (min ? keys[i] < keys[best]
+                                                      : keys[i] > keys[best])))
+                        best = i;
+                uint64_t k;
+                void *p;
+                bool replace = below(4) == 0;
+                if (replace) {
+                    keys[n] = key;
+                    CHECK(keyed_heap_replace(h, key, &keys[n], &k, &p));
+                    live[n++] = true;
+                } else {
+                    CHECK(keyed_heap_extract(h, &k, &p));
+                    nlive--;
+                }
+                CHECK(k == keys[best]);
+                if (cfgs[c].stable) CHECK(p == &keys[best]);
+                uint64_t *slot = p;
+                live[slot - keys] = false;
+            }
+            CHECK(keyed_heap_size(h) == nlive);
+            if (step % 500 == 0) CHECK(keyed_heap_validate(h));
+        }
+        keyed_heap_destroy(h);
+    }
+}
+
+// --- RadixHeap ---
+
+static void test_radix(void) {
+    RadixHeap *h = radix_heap_create();
+    CHECK(h != NULL);
+    static uint64_t live[4000];
+    size_t n = 0;
+    uint64_t last = 0;
+    for (int step = 0; step < 20000; step++) {
+        if ((below(2) || n == 0) && n < 4000) {
+            uint64_t k = last + below(1000);
+            CHECK(radix_heap_insert(h, k, NULL) == 0);
+            live[n++] = k;
+        } else {
+            size_t best = 0;
+            for (size_t i = 1; i < n; i++)
+                if (live[i] < live[best]) best = i;
+            uint64_t pk, k;
+            CHECK(radix_heap_peek(h, &pk, NULL));
+            CHECK(radix_heap_extract(h, &k, NULL));
+            CHECK(k == live[best] && pk == k);
+            last = k;
+            live[best] = live[--n];
+        }
+        CHECK(radix_heap_size(h) == n);
+    }
+    if (n > 0) CHECK(radix_heap_insert(h, last - 1, NULL) == RADIX_HEAP_ERR_KEY);
+    radix_heap_destroy(h);
+}
+
+// --- MinMaxHeap ---
+
+static void test_minmax(void) {
+    MinMaxHeap *h = minmax_heap_create(item_cmp, 0);
+    CHECK(h != NULL);
+    model.n = 0;
+    for (int step = 0; step < 8000; step++) {
+        size_t op = below(4);
+        if (op < 2 || model.n == 0) {
+            Item *it = new_item(300);
+            CHECK(minmax_heap_insert(h, it) == 0);
+            model_add(&model, it);
+        } else if (op == 2) {
+            model_take(&model, minmax_heap_extract_max(h), false);
+        } else {
+            size_t lo = 0;
+            for (size_t i = 1; i < model.n; i++)
+                if (model.items[i]->key < model.items[lo]->key) lo = i;
+            Item *got = minmax_heap_extract_min(h);
+            CHECK(got && got->key == model.items[lo]->key);
+            if (got) model_del(&model, model_find(&model, got));
+        }
+        if (step % 500 == 0) CHECK(minmax_heap_validate(h));
+        CHECK(minmax_heap_size(h) == model.n);
+    }
+    minmax_heap_destroy(h);
+}
+
+// --- PairingHeap ---
+
+static void test_pairing(void) {
+    PairingHeap *h = pairing_heap_create(item_cmp);
+    CHECK(h != NULL);
+    static PairingNode *nodes[POOL];
+    static Item *owner[POOL];
+    size_t nn = 0;
+    model.n = 0;
+    for (int step = 0; step < 8000; step++) {
+        size_t op = below(6);
+        if (op < 3 || model.n == 0) {
+            Item *it = new_item(1000);
+            nodes[nn] = pairing_heap_insert(h, it);
+            owner[nn++] = it;
+            model_add(&model, it);
+        } else if (op == 3) {
+            Item *it = pairing_heap_extract(h);
+            model_take(&model, it, false);
+            for (size_t k = 0; k < nn; k++)
+                if (owner[k] == it) { nodes[k] = nodes[--nn]; owner[k] = owner[nn]; break; }
+        } else if (nn > 0) {
+            size_t k = below(nn);
+            if (op == 4) {
+                owner[k]->key += (int)below(200);
+                pairing_heap_promote(h, nodes[k]);
+            } else {
+                CHECK(pairing_heap_remove(h, nodes[k]) == owner[k]);
+                model_del(&model, model_find(&model, owner[k]));
+                nodes[k] = nodes[--nn];
+                owner[k] = owner[nn];
+            }
+        }
+        CHECK(pairing_heap_size(h) == model.n);
+        if (model.n) CHECK(((Item *)pairing_heap_peek(h))->key ==
+                           model.items[model_top(&model)]->key);
+    }
+    pairing_heap_destroy(h);
+}
+
+// --- TimerWheel ---
+
+static void test_timer_wheel(void) {
+    enum { N = 3000 };
+    TimerWheel *w = timer_wheel_create(0, 4);
+    CHECK(w != NULL);
+    static uint64_t deadline[N];
+    static WheelTimer *t[N];
+    static bool done[N];
+    for (size_t i = 0; i < N; i++) {
+        // Mostly near, some past the wheel's range (overflow list).
+        deadline[i] = below(10) ? below(200000) : (uint64_t)1 << 26 | below(1000);
+        t[i] = timer_wheel_add(w, deadline[i], &deadline[i]);
+        CHECK(t[i] != NULL);
+    }
+    size_t left = N;
+    for (size_t i = 0; i < N; i += 7) {
+        CHECK(timer_wheel_cancel(w, t[i]) == &deadline[i]);
+        done[i] = true;
+        left--;
+    }
+    uint64_t now = 0, prev = 0;
+    void *out[64];
+    while (left > 0) {
+        now += 1 + below(5000);
+        if (now > 200000) now = (uint64_t)1 << 27;
+        size_t n;
+        while ((n = timer_wheel_advance(w, now, out, 64)) > 0) {
+            for (size_t k = 0; k < n; k++) {
+                uint64_t *d = out[k];
+                size_t i = (size_t)(d - deadline);
+                CHECK(!done[i] && *d <= now && *d >= prev);
+                done[i] = true;
+                prev = *d;
+                left--;
+            }
+        }
+        CHECK(timer_wheel_size(w) == left);
+    }
+    timer_wheel_destroy(w);
+}
+
+// --- HeapMergeIter ---
+
+typedef struct Stream {
+    int *v;
+    size_t n, pos;
+} Stream;
+
+static bool stream_next(void *ctx, void **out) {
+    Stream *s = ctx;
+    if (s->pos == s->n) return false;
+    *out = &s->v[s->pos++];
+    return true;
+}
+
+static void test_merge_iter(void) {
+    enum { K = 9, N = 400 };
+    static int v[K][N];
+    Stream st[K];
+    HeapSource src[K];
+    size_t total = 0;
+    for (size_t s = 0; s < K; s++) {
+        size_t n = below(N);
+        for (size_t i = 0; i < n; i++)
+            v[s][i] = (int)below(100);
+        qsort(v[s], n, sizeof(int), int_cmp);
+        st[s] = (Stream){ v[s], n, 0 };
+        src[s] = (HeapSource){ stream_next, &st[s] };
+        total += n;
+    }
+    HeapMergeIter *it = heap_merge_iter_create(src, K, int_cmp);
+    CHECK(it != NULL);
+    void *out[50];
+    size_t n, got = 0;
+    int *prev = NULL;
+    while ((n = heap_merge_iter_next(it, out, 50)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            int *x = out[i];
+            // Ascending; equal values in source order (rows are arrays).
+            if (prev) CHECK(*prev < *x || (*prev == *x && (size_t)(prev - &v[0][0]) / N <=
+                                                          (size_t)(x - &v[0][0]) / N));
+            prev = x;
+        }
+        got += n;
+    }
+    CHECK(got == total);
+    heap_merge_iter_destroy(it);
+}
+
+// --- ConcHeap, HeapSched (single-threaded semantics) ---
+
+static void test_conc(void) {
+    ConcHeap *q = conc_heap_create(item_cmp, 4, CONC_HEAP_STRICT);
+    CHECK(q != NULL);
+    model.n = 0;
+    for (int i = 0; i < 2000; i++) {
+        Item *it = new_item(1000);
+        CHECK(conc_heap_insert(q, it) == 0);
+        model_add(&model, it);
+    }
+    while (model.n > 0)
+        model_take(&model, conc_heap_extract(q), false);
+    CHECK(conc_heap_extract(q) == NULL);
+    conc_heap_destroy(q);
+
+    HeapSched *s = heap_sched_create(item_cmp, 3);
+    CHECK(s != NULL);
+    for (int i = 0; i < 900; i++)
+        CHECK(heap_sched_push(s, (size_t)i % 3, new_item(1000)) == 0);
+    CHECK(heap_sched_steal(s, 0, 1, 10) > 0);
+    // Pops steal once the local heap is empty, so only count them.
+    size_t popped = 0;
+    for (size_t wk = 0; wk < 3; wk++)
+        while (heap_sched_pop(s, wk) != NULL)
+            popped++;
+    CHECK(popped == 900 && heap_sched_size(s) == 0);
+    heap_sched_destroy(s);
+}
+
+// --- ExtHeap, HeapFile ---
+
+static const char *tmp_dir(void) {
+    const char *d = getenv("TMPDIR");
+    return d && *d ? d : "/tmp";
+}
+
+static void test_ext(void) {
+    enum { N = 60000 };
+    // A 16 KiB budget spills every few hundred inserts and cascades.
+    ExtHeap *q = ext_heap_create(sizeof(uint64_t), u64_cmp, 1 << 14, NULL);
+    CHECK(q != NULL);
+    static uint64_t ref[N];
+    for (size_t i = 0; i < N; i++) {
+        ref[i] = rng() % 1000000;
+        CHECK(ext_heap_insert(q, &ref[i]) == 0);
+    }
+    CHECK(ext_heap_runs(q) > 1 && ext_heap_size(q) == N);
+    qsort(ref, N, sizeof(uint64_t), u64_cmp);
+    for (size_t i = N; i-- > 0;) {
+        uint64_t x = 0;
+        CHECK(ext_heap_extract(q, &x) == 1);
+        CHECK(x == ref[i]);
+    }
+    CHECK(ext_heap_extract(q, NULL) == 0);
+    ext_heap_destroy(q);
+}
+
+static void test_file(void) {
+    enum { N = 5000 };
+    char path[256];
+    snprintf(path, sizeof(path), "%s/heap_test.%ld", tmp_dir(), (long)getpid());
+    static int ref[N];
+    for (unsigned arity = 2; arity <= 8; arity *= 2) {
+        HeapFile *f = heap_file_create(path, sizeof(int), arity, int_cmp);
+        CHECK(f != NULL);
+        if (!f) break;
+        for (size_t i = 0; i < N; i++) {
+            ref[i] = (int)below(100000);
+            CHECK(heap_file_insert(f, &ref[i]) == 0);
+        }
+        int x;
+        for (size_t i = 0; i < N / 2; i++)
+            CHECK(heap_file_extract(f, &x));
+        CHECK(heap_file_validate(f));
+        CHECK(heap_file_close(f) == 0);
+
+        f = heap_file_open(path, int_cmp);
+        CHECK(f != NULL && heap_file_size(f) == N - N / 2);
+        if (!f) break;
+        CHECK(heap_file_validate(f));
+        qsort(ref, N, sizeof(int), int_cmp);
+        for (size_t i = N - N / 2; i-- > 0;) {
+            CHECK(heap_file_extract(f, &x));
+            CHECK(x == ref[i]);
+        }
+        CHECK(!heap_file_extract(f, &x));
+        heap_file_close(f);
+    }
+    unlink(path);
+}
+
+// -----------------------------------------------------------
+// Driver
+// -----------------------------------------------------------
+
+typedef struct Group {
+    const char *name;
+    void (*run)(void);
+} Group;
+
+static const Group groups[] = {
+    { "heap",         test_heap },
+    { "keyed_heap",   test_keyed },
+    { "radix_heap",   test_radix },
+    { "minmax_heap",  test_minmax },
+    { "pairing_heap", test_pairing },
+    { "timer_wheel",  test_timer_wheel },
+    { "merge_iter",   test_merge_iter },
+    { "conc_sched",   test_conc },
+    { "ext_heap",     test_ext },
+    { "heap_file",    test_file },
+};
+
+int main(void) {
+    int failed = 0;
+    for (size_t g = 0; g < sizeof(groups) / sizeof(groups[0]); g++) {
+        int before = failures;
+        groups[g].run();
+        bool ok = failures == before;
+        printf("%-14s %s\n", groups[g].name, ok ? "ok" : "FAILED");
+        failed += !ok;
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
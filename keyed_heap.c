@@ -0,0 +1,495 @@
+// Keyed binary heap implementation in C
+// -----------------------------------------------
+// - Stores (uint64_t key, void *payload) pairs inline in one array
+// - Comparisons read keys straight out of the array: no comparator
+//   callback and no pointer chasing into payload memory
+// - Min-heaps are max-heaps over bit-inverted keys, so there is exactly
+//   one comparison routine
+// - Binary, 4-ary or 8-ary; for 4/8-ary heaps the best child is picked
+//   with AVX2 (runtime-detected) or NEON, scalar otherwise
+// - Stable heaps keep full 64-bit keys and a parallel array of 32-bit
+//   insertion stamps, read only when two keys compare equal
+//
+// Use this instead of Heap when priorities are integers, timestamps or
+// doubles (see keyed_heap_key_from_double).
+//
+// -----------------------------------------------
+
+#include "keyed_heap.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define KEYED_HEAP_AVX2 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define KEYED_HEAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+#define KEYED_HEAP_DEFAULT_CAP 16
+#define KEYED_HEAP_CACHE_LINE  64
+#define KEYED_HEAP_SEQ_MAX     UINT32_MAX  // stamps are 0 .. SEQ_MAX - 1
+
+// One slot of the backing array. Key first so sifts touch the key and
+// its payload in the same cache line.
+typedef struct KeyedEntry {
+    uint64_t key;         // key ^ mask
+    void *payload;
+} KeyedEntry;
+
+typedef void (*keyed_sift_fn)(KeyedHeap *h, size_t i);
+
+struct KeyedHeap {
+    KeyedEntry *data;     // dynamic array of entries (inside `block`)
+    void *block;          // raw allocation; data[1] starts a cache line
+    uint32_t *seq;        // stable heaps: ~stamp of data[i], else NULL
+    size_t size;          // current number of entries
+    size_t capacity;      // allocated capacity
+    uint64_t mask;        // 0 for max-heap, all ones for min-heap
+    size_t arity;         // children per node (2, 4 or 8)
+    unsigned shift;       // log2(arity)
+    keyed_sift_fn sift_down; // chosen once at create time
+    uint32_t next_seq;    // stamp of the next stable insert
+};
+
+// --- Utility index helpers ---
+// Children of i are arity*i + 1 .. arity*i + arity.
+static inline size_t parent(const KeyedHeap *h, size_t i) { return (i - 1) >> h->shift; }
+static inline size_t child(const KeyedHeap *h, size_t i)  { return (i << h->shift) + 1; }
+
+// Offset `data` inside the raw block so data[1] starts a cache line:
+// a 4-ary sibling group is then exactly one line, an 8-ary group two
+// adjacent lines.
+static inline KeyedEntry *align_data(void *block) {
+    uintptr_t p = (uintptr_t)block + sizeof(KeyedEntry);
+    p = (p + KEYED_HEAP_CACHE_LINE - 1) & ~(uintptr_t)(KEYED_HEAP_CACHE_LINE - 1);
+    return (KeyedEntry *)(p - sizeof(KeyedEntry));
+}
+
+static inline size_t block_bytes(size_t capacity) {
+    return capacity * sizeof(KeyedEntry) + KEYED_HEAP_CACHE_LINE;
+}
+
+// --- Heapify helpers ---
+// Both sifts carry the moving entry in a local and shift the others
+// into the hole, so each level costs one 16-byte store instead of a swap.
+// In a stable heap seq[] moves along with data[]; seq holds inverted
+// stamps, so of two equal keys the one with the larger seq came first.
+
+// Only called on a fresh insert. Its stamp is the newest, so it loses
+// every tie and the plain key compare is exact in stable heaps too.
+static void sift_up(KeyedHeap *h, size_t i) {
+    KeyedEntry e = h->data[i];
+    uint32_t *seq = h->seq;
+    uint32_t s = seq ? seq[i] : 0;
+    while (i > 0) {
+        size_t p = parent(h, i);
+        if (e.key <= h->data[p].key)
+            break;
+        h->data[i] = h->data[p];
+        if (seq) seq[i] = seq[p];
+        i = p;
+    }
+    h->data[i] = e;
+    if (seq) seq[i] = s;
+}
+
+// Offset of the first largest key among e[0..n).
+static inline size_t max_child_scalar(const KeyedEntry *e, size_t n) {
+    size_t best = 0;
+    for (size_t j = 1; j < n; j++)
+        if (e[j].key > e[best].key)
+            best = j;
+    return best;
+}
+
+static void sift_down_scalar(KeyedHeap *h, size_t i) {
+    KeyedEntry e = h->data[i];
+    for (;;) {
+        size_t c = child(h, i);
+        if (c >= h->size)
+            break;
+        size_t n = h->size - c;
+        if (n > h->arity) n = h->arity;
+        c += max_child_scalar(&h->data[c], n);
+        if (h->data[c].key <= e.key)
+            break;
+        h->data[i] = h->data[c];
+        i = c;
+    }
+    h->data[i] = e;
+}
+
+// Offset of the earliest entry among the lanes set in `lanes` (nonzero),
+// all of which hold the same key.
+static inline size_t earliest(const uint32_t *seq, unsigned lanes) {
+    size_t best = (size_t)__builtin_ctz(lanes);
+    for (lanes &= lanes - 1; lanes; lanes &= lanes - 1) {
+        size_t j = (size_t)__builtin_ctz(lanes);
+        if (seq[j] > seq[best])
+            best = j;
+    }
+    return best;
+}
+
+// Bitmask of the entries among e[0..n) holding the largest key.
+static inline unsigned max_lanes_scalar(const KeyedEntry *e, size_t n) {
+    uint64_t m = e[0].key;
+    unsigned lanes = 1;
+    for (size_t j = 1; j < n; j++) {
+        if (e[j].key > m) {
+            m = e[j].key;
+            lanes = 1u << j;
+        } else if (e[j].key == m) {
+            lanes |= 1u << j;
+        }
+    }
+    return lanes;
+}
+
+// Stable variant: the best child is the earliest of the tied largest
+// keys, and a child equal to the moving entry rises only if it is older.
+// The stamp compare runs only when a key compare comes out equal.
+#define KEYED_SIFT_DOWN_STABLE(fn, max_lanes)                               \
+    static void fn(KeyedHeap *h, size_t i) {                                \
+        KeyedEntry e = h->data[i];                                          \
+        uint32_t *seq = h->seq;                                             \
+        uint32_t s = seq[i];                                                \
+        for (;;) {                                                          \
+            size_t c = child(h, i);                                         \
+            if (c >= h->size)                                               \
+                break;                                                      \
+            size_t n = h->size - c;                                         \
+            unsigned lanes = max_lanes(&h->data[c], n, h->arity);           \
+            c += (lanes & (lanes - 1)) ? earliest(&seq[c], lanes)           \
+                                       : (size_t)__builtin_ctz(lanes);      \
+            if (h->data[c].key < e.key ||                                   \
+                (h->data[c].key == e.key && seq[c] < s))                    \
+                break;                                                      \
+            h->data[i] = h->data[c];                                        \
+            seq[i] = seq[c];                                                \
+            i = c;                                                          \
+        }                                                                   \
+        h->data[i] = e;                                                     \
+        seq[i] = s;                                                         \
+    }
+
+static inline unsigned group_lanes_scalar(const KeyedEntry *e, size_t n, size_t arity) {
+    return max_lanes_scalar(e, n < arity ? n : arity);
+}
+
+KEYED_SIFT_DOWN_STABLE(sift_down_stable_scalar, group_lanes_scalar)
+
+// --- SIMD child selection ---
+// A full sibling group is a max-reduction over 4 or 8 keys sitting at a
+// 16-byte stride. The vector paths find the maximum and return the mask
+// of lanes equal to it; plain heaps take the lowest lane, so ties resolve
+// exactly like the scalar path. Partial groups at the bottom level fall
+// back to the scalar helpers.
+
+#define KEYED_SIFT_DOWN_SIMD(fn, ARITY, max_lanes_full)                     \
+    static void fn(KeyedHeap *h, size_t i) {                                \
+        KeyedEntry e = h->data[i];                                          \
+        for (;;) {                                                          \
+            size_t c = child(h, i);                                         \
+            if (c >= h->size)                                               \
+                break;                                                      \
+            if (h->size - c >= (ARITY))                                     \
+                c += (size_t)__builtin_ctz(max_lanes_full(&h->data[c]));    \
+            else                                                            \
+                c += max_child_scalar(&h->data[c], h->size - c);            \
+            if (h->data[c].key <= e.key)                                    \
+                break;                                                      \
+            h->data[i] = h->data[c];                                        \
+            i = c;                                                          \
+        }                                                                   \
+        h->data[i] = e;                                                     \
+    }
+
+// Group lanes for the stable sift: vector path for full groups.
+#define KEYED_GROUP_LANES(fn, ARITY, max_lanes_full)                        \
+    static inline unsigned fn(const KeyedEntry *e, size_t n, size_t arity) { \
+        (void)arity;                                                        \
+        return n >= (ARITY) ? max_lanes_full(e) : max_lanes_scalar(e, n);   \
+    }
+
+#if KEYED_HEAP_AVX2
+
+#define KEYED_AVX2 __attribute__((target("avx2")))
+
+// Gather the keys of e[0..4) into one vector, biased so that signed
+// 64-bit compares order them as unsigned.
+KEYED_AVX2 static inline __m256i load_keys4(const KeyedEntry *e) {
+    __m256i lo = _mm256_loadu_si256((const __m256i *)(const void *)e);       // k0 p0 k1 p1
+    __m256i hi = _mm256_loadu_si256((const __m256i *)(const void *)(e + 2)); // k2 p2 k3 p3
+    __m256i k = _mm256_unpacklo_epi64(lo, hi);                               // k0 k2 k1 k3
+    k = _mm256_permute4x64_epi64(k, _MM_SHUFFLE(3, 1, 2, 0));                // k0 k1 k2 k3
+    return _mm256_xor_si256(k, _mm256_set1_epi64x(INT64_MIN));
+}
+
+KEYED_AVX2 static inline __m256i max_epi64(__m256i a, __m256i b) {
+    return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a));
+}
+
+// Broadcast the maximum lane of v to all lanes.
+KEYED_AVX2 static inline __m256i hmax_epi64(__m256i v) {
+    v = max_epi64(v, _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    return max_epi64(v, _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+KEYED_AVX2 static inline int lanes_eq(__m256i a, __m256i b) {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)));
+}
+
+KEYED_AVX2 static inline unsigned max_lanes4_avx2(const KeyedEntry *e) {
+    __m256i k = load_keys4(e);
+    return (unsigned)lanes_eq(k, hmax_epi64(k));
+}
+
+KEYED_AVX2 static inline unsigned max_lanes8_avx2(const KeyedEntry *e) {
+    __m256i a = load_keys4(e), b = load_keys4(e + 4);
+    __m256i m = hmax_epi64(max_epi64(a, b));
+    return (unsigned)lanes_eq(a, m) | ((unsigned)lanes_eq(b, m) << 4);
+}
+
+KEYED_AVX2 KEYED_SIFT_DOWN_SIMD(sift_down4_avx2, 4, max_lanes4_avx2)
+KEYED_AVX2 KEYED_SIFT_DOWN_SIMD(sift_down8_avx2, 8, max_lanes8_avx2)
+KEYED_AVX2 KEYED_GROUP_LANES(group_lanes4_avx2, 4, max_lanes4_avx2)
+KEYED_AVX2 KEYED_GROUP_LANES(group_lanes8_avx2, 8, max_lanes8_avx2)
+KEYED_AVX2 KEYED_SIFT_DOWN_STABLE(sift_down4_stable_avx2, group_lanes4_avx2)
+KEYED_AVX2 KEYED_SIFT_DOWN_STABLE(sift_down8_stable_avx2, group_lanes8_avx2)
+
+#elif KEYED_HEAP_NEON
+
+// vld2q_u64 de-interleaves (key, payload) pairs: val[0] holds two keys.
+static inline uint64x2_t load_keys2(const KeyedEntry *e) {
+    return vld2q_u64((const uint64_t *)(const void *)e).val[0];
+}
+
+static inline uint64x2_t max_u64(uint64x2_t a, uint64x2_t b) {
+    return vbslq_u64(vcgtq_u64(b, a), b, a);
+}
+
+// Bitmask of the lanes of v equal to m.
+static inline unsigned lanes_eq(uint64x2_t v, uint64x2_t m) {
+    uint64x2_t eq = vceqq_u64(v, m);
+    return (unsigned)(vgetq_lane_u64(eq, 0) & 1) |
+           (unsigned)((vgetq_lane_u64(eq, 1) & 1) << 1);
+}
+
+static inline uint64x2_t hmax_u64(uint64x2_t v) {
+    uint64_t a = vgetq_lane_u64(v, 0), b = vgetq_lane_u64(v, 1);
+    return vdupq_n_u64(a > b ? a : b);
+}
+
+static inline unsigned max_lanes4_neon(const KeyedEntry *e) {
+    uint64x2_t a = load_keys2(e), b = load_keys2(e + 2);
+    uint64x2_t m = hmax_u64(max_u64(a, b));
+    return lanes_eq(a, m) | (lanes_eq(b, m) << 2);
+}
+
+static inline unsigned max_lanes8_neon(const KeyedEntry *e) {
+    uint64x2_t a = load_keys2(e), b = load_keys2(e + 2);
+    uint64x2_t c = load_keys2(e + 4), d = load_keys2(e + 6);
+    uint64x2_t m = hmax_u64(max_u64(max_u64(a, b), max_u64(c, d)));
+    return lanes_eq(a, m) | (lanes_eq(b, m) << 2) |
+           (lanes_eq(c, m) << 4) | (lanes_eq(d, m) << 6);
+}
+
+KEYED_SIFT_DOWN_SIMD(sift_down4_neon, 4, max_lanes4_neon)
+KEYED_SIFT_DOWN_SIMD(sift_down8_neon, 8, max_lanes8_neon)
+KEYED_GROUP_LANES(group_lanes4_neon, 4, max_lanes4_neon)
+KEYED_GROUP_LANES(group_lanes8_neon, 8, max_lanes8_neon)
+KEYED_SIFT_DOWN_STABLE(sift_down4_stable_neon, group_lanes4_neon)
+KEYED_SIFT_DOWN_STABLE(sift_down8_stable_neon, group_lanes8_neon)
+
+#endif
+
+// Pick the sift-down implementation for an arity on this CPU.
+static keyed_sift_fn select_sift_down(size_t arity, bool stable) {
+#if KEYED_HEAP_AVX2
+    if (arity >= 4 && __builtin_cpu_supports("avx2")) {
+        if (stable)
+            return arity == 4 ? sift_down4_stable_avx2 : sift_down8_stable_avx2;
+        return arity == 4 ? sift_down4_avx2 : sift_down8_avx2;
+    }
+#elif KEYED_HEAP_NEON
+    if (arity >= 4) {
+        if (stable)
+            return arity == 4 ? sift_down4_stable_neon : sift_down8_stable_neon;
+        return arity == 4 ? sift_down4_neon : sift_down8_neon;
+    }
+#endif
+    (void)arity;
+    return stable ? sift_down_stable_scalar : sift_down_scalar;
+}
+
+// --- Stable stamps ---
+
+static inline void swap_slots(KeyedHeap *h, size_t a, size_t b) {
+    KeyedEntry e = h->data[a];
+    h->data[a] = h->data[b];
+    h->data[b] = e;
+    uint32_t s = h->seq[a];
+    h->seq[a] = h->seq[b];
+    h->seq[b] = s;
+}
+
+// The sequence is about to run out: heapsort in place, reverse (a
+// descending array is heap-ordered) and restamp by position, which keeps
+// every tie in order and lets new stamps continue from size.
+static void renumber(KeyedHeap *h) {
+    size_t n = h->size;
+    while (h->size > 1) {
+        swap_slots(h, 0, h->size - 1);
+        h->size--;
+        h->sift_down(h, 0);
+    }
+    h->size = n;
+    for (size_t i = 0, j = n; i + 1 < j; i++, j--)
+        swap_slots(h, i, j - 1);
+    for (size_t i = 0; i < n; i++)
+        h->seq[i] = ~(uint32_t)i;
+    h->next_seq = (uint32_t)n;
+}
+
+// Make room for one more stamp; fails past SEQ_MAX entries.
+static inline int reserve_seq(KeyedHeap *h) {
+    if (!h->seq || h->next_seq < KEYED_HEAP_SEQ_MAX) return 0;
+    if (h->size >= KEYED_HEAP_SEQ_MAX) return -1;
+    renumber(h);
+    return 0;
+}
+
+// Fill slot i with a new entry, stamping it in a stable heap.
+static inline void put(KeyedHeap *h, size_t i, uint64_t key, void *payload) {
+    h->data[i].key = key ^ h->mask;
+    h->data[i].payload = payload;
+    if (h->seq) h->seq[i] = ~h->next_seq++;
+}
+
+// -----------------------------------------------------------
+// Public API
+// -----------------------------------------------------------
+
+KeyedHeap *keyed_heap_create(KeyedHeapOrder order, size_t capacity) {
+    KeyedHeapConfig cfg = { .order = order };
+    return keyed_heap_create_ex(capacity, &cfg);
+}
+
+KeyedHeap *keyed_heap_create_ex(size_t capacity, const KeyedHeapConfig *cfg) {
+    KeyedHeapOrder order = cfg ? cfg->order : KEYED_HEAP_MAX;
+    size_t arity = (cfg && cfg->arity) ? cfg->arity : 2;
+    if (arity != 2 && arity != 4 && arity != 8) return NULL;
+    if (capacity == 0) capacity = KEYED_HEAP_DEFAULT_CAP;
+
+    KeyedHeap *h = calloc(1, sizeof(*h));
+    if (!h) return NULL;
+
+    h->block = malloc(block_bytes(capacity));
+    if (!h->block) { free(h); return NULL; }
+
+    bool stable = cfg && cfg->stable;
+    if (stable) {
+        h->seq = malloc(capacity * sizeof(uint32_t));
+        if (!h->seq) { free(h->block); free(h); return NULL; }
+    }
+
+    h->data = align_data(h->block);
+    h->capacity = capacity;
+    h->mask = (order == KEYED_HEAP_MIN) ? ~UINT64_C(0) : 0;
+    h->arity = arity;
+    h->shift = arity == 2 ? 1 : arity == 4 ? 2 : 3;
+    h->sift_down = select_sift_down(arity, stable);
+    return h;
+}
+
+void keyed_heap_destroy(KeyedHeap *h) {
+    if (!h) return;
+    free(h->seq);
+    free(h->block);
+    free(h);
+}
+
+int keyed_heap_reserve(KeyedHeap *h, size_t n) {
+    if (h->capacity >= n) return 0;
+    // Grow seq first: if the block then fails, a larger seq is harmless.
+    if (h->seq) {
+        uint32_t *seq = realloc(h->seq, n * sizeof(uint32_t));
+        if (!seq) return -1;
+        h->seq = seq;
+    }
+    size_t old_off = (size_t)((char *)h->data - (char *)h->block);
+    void *tmp = realloc(h->block, block_bytes(n));
+    if (!tmp) return -1;
+    KeyedEntry *data = align_data(tmp);
+    size_t new_off = (size_t)((char *)data - (char *)tmp);
+    if (new_off != old_off)
+        memmove(data, (char *)tmp + old_off, h->size * sizeof(KeyedEntry));
+    h->block = tmp;
+    h->data = data;
+    h->capacity = n;
+    return 0;
+}
+
+int keyed_heap_insert(KeyedHeap *h, uint64_t key, void *payload) {
+    if (h->size == h->capacity) {
+        if (keyed_heap_reserve(h, h->capacity * 2) < 0)
+            return -1;
+    }
+    if (reserve_seq(h) < 0)
+        return -1;
+    put(h, h->size, key, payload);
+    sift_up(h, h->size);
+    h->size++;
+    return 0;
+}
+
+bool keyed_heap_peek(const KeyedHeap *h, uint64_t *key, void **payload) {
+    if (!h || h->size == 0) return false;
+    if (key) *key = h->data[0].key ^ h->mask;
+    if (payload) *payload = h->data[0].payload;
+    return true;
+}
+
+bool keyed_heap_extract(KeyedHeap *h, uint64_t *key, void **payload) {
+    if (!keyed_heap_peek(h, key, payload)) return false;
+    h->data[0] = h->data[h->size - 1];
+    if (h->seq) h->seq[0] = h->seq[h->size - 1];
+    h->size--;
+    if (h->size > 0)
+        h->sift_down(h, 0);
+    return true;
+}
+
+bool keyed_heap_replace(KeyedHeap *h, uint64_t key, void *payload,
+                        uint64_t *old_key, void **old_payload) {
+    if (!keyed_heap_peek(h, old_key, old_payload)) return false;
+    (void)reserve_seq(h);  // cannot fail: the size does not grow
+    put(h, 0, key, payload);
+    h->sift_down(h, 0);
+    return true;
+}
+
+size_t keyed_heap_size(const KeyedHeap *h) {
+    return h ? h->size : 0;
+}
+
+void keyed_heap_clear(KeyedHeap *h) {
+    if (!h) return;
+    h->size = 0;
+    h->next_seq = 0;
+}
+
+bool keyed_heap_validate(const KeyedHeap *h) {
+    if (!h) return false;
+    for (size_t i = 1; i < h->size; i++) {
+        size_t p = parent(h, i);
+        if (h->data[i].key > h->data[p].key)
+            return false;
+        if (h->seq && h->data[i].key == h->data[p].key && h->seq[i] > h->seq[p])
+            return false;
+    }
+    return true;
+}
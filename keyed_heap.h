@@ -0,0 +1,153 @@
+#ifndef KEYED_HEAP_H
+#define KEYED_HEAP_H
+
+#include <stddef.h> // size_t
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Ordering of a keyed heap.
+ *
+ * KEYED_HEAP_MAX keeps the largest key at the root, KEYED_HEAP_MIN the
+ * smallest (the usual choice for timers and deadlines).
+ */
+typedef enum KeyedHeapOrder {
+    KEYED_HEAP_MAX = 0,
+    KEYED_HEAP_MIN = 1
+} KeyedHeapOrder;
+
+typedef struct KeyedHeap KeyedHeap;
+
+/**
+ * @brief Optional keyed heap configuration for keyed_heap_create_ex().
+ *
+ * Zero-initialize and set only the fields you need; zero means default.
+ */
+typedef struct KeyedHeapConfig {
+    KeyedHeapOrder order;   /**< KEYED_HEAP_MAX (default) or KEYED_HEAP_MIN */
+    /**
+     * Children per node: 2 (default), 4 or 8. For 4 and 8 the best child
+     * is selected with AVX2 (detected at runtime) or NEON when available.
+     */
+    unsigned arity;
+    /**
+     * FIFO among equal keys: entries with the same key leave in insertion
+     * order. Keys keep their full 64 bits; a 32-bit insertion sequence
+     * per entry sits in a parallel array and is read only when two keys
+     * compare equal.
+     */
+    bool stable;
+} KeyedHeapConfig;
+
+/**
+ * @brief Create a new keyed heap.
+ *
+ * Entries are (uint64_t key, void *payload) pairs stored inline in the
+ * backing array, so comparisons never dereference the payload and never
+ * go through a comparator callback.
+ *
+ * @param order KEYED_HEAP_MAX or KEYED_HEAP_MIN.
+ * @param capacity Optional initial capacity (0 for default).
+ * @return Pointer to KeyedHeap or NULL on failure.
+ */
+KeyedHeap *keyed_heap_create(KeyedHeapOrder order, size_t capacity);
+
+/**
+ * @brief Create a new keyed heap with explicit configuration.
+ *
+ * @param capacity Optional initial capacity (0 for default).
+ * @param cfg Configuration, or NULL for a binary max-heap.
+ * @return Pointer to KeyedHeap or NULL on failure or unsupported config.
+ */
+KeyedHeap *keyed_heap_create_ex(size_t capacity, const KeyedHeapConfig *cfg);
+
+/**
+ * @brief Free keyed heap memory (payloads are not touched).
+ */
+void keyed_heap_destroy(KeyedHeap *h);
+
+/**
+ * @brief Insert a (key, payload) pair.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int keyed_heap_insert(KeyedHeap *h, uint64_t key, void *payload);
+
+/**
+ * @brief Get root entry without removing it.
+ *
+ * Either output pointer may be NULL.
+ * @return false if the heap is empty.
+ */
+bool keyed_heap_peek(const KeyedHeap *h, uint64_t *key, void **payload);
+
+/**
+ * @brief Remove root entry and return it through key/payload.
+ *
+ * Either output pointer may be NULL.
+ * @return false if the heap is empty.
+ */
+bool keyed_heap_extract(KeyedHeap *h, uint64_t *key, void **payload);
+
+/**
+ * @brief Replace root entry with a new pair, returning the old root.
+ *
+ * Cheaper than extract + insert: a single sift-down.
+ * @return false if the heap is empty (nothing is inserted then).
+ */
+bool keyed_heap_replace(KeyedHeap *h, uint64_t key, void *payload,
+                        uint64_t *old_key, void **old_payload);
+
+/**
+ * @brief Number of entries in heap.
+ */
+size_t keyed_heap_size(const KeyedHeap *h);
+
+/**
+ * @brief Ensure heap capacity for at least n entries.
+ */
+int keyed_heap_reserve(KeyedHeap *h, size_t n);
+
+/**
+ * @brief Remove all entries (keeps capacity).
+ */
+void keyed_heap_clear(KeyedHeap *h);
+
+/**
+ * @brief Check heap validity (for debugging).
+ * @return true if valid heap property.
+ */
+bool keyed_heap_validate(const KeyedHeap *h);
+
+/**
+ * @brief Map a double to a uint64_t key with the same ordering.
+ *
+ * -0.0 sorts just below +0.0; NaNs sort beyond the infinities.
+ */
+static inline uint64_t keyed_heap_key_from_double(double d) {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return (bits & UINT64_C(0x8000000000000000)) ? ~bits
+                                                 : bits | UINT64_C(0x8000000000000000);
+}
+
+/**
+ * @brief Inverse of keyed_heap_key_from_double().
+ */
+static inline double keyed_heap_key_to_double(uint64_t key) {
+    uint64_t bits = (key & UINT64_C(0x8000000000000000))
+                        ? key & ~UINT64_C(0x8000000000000000)
+                        : ~key;
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,213 @@
+// Min-max heap implementation in C
+// -----------------------------------------------
+// - One array, binary layout: nodes on even levels (root = level 0) are
+//   <= all their descendants, nodes on odd levels >= all descendants
+// - Minimum is the root, maximum the larger of the root's children
+// - Insert bubbles up along grandparents of the matching kind; removal
+//   trickles down choosing among children and grandchildren
+//   (Atkinson et al., 1986)
+//
+// Min and max levels run the same code with the comparison mirrored, so
+// every helper takes `max` (true on max levels).
+//
+// -----------------------------------------------
+
+#include "minmax_heap.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MINMAX_HEAP_DEFAULT_CAP 16
+
+struct MinMaxHeap {
+    void **data;          // dynamic array of pointers
+    size_t size;          // current number of elements
+    size_t capacity;      // allocated capacity
+    heap_cmp_fn cmp;      // user-provided comparison function
+};
+
+// --- Utility index helpers ---
+static inline size_t parent(size_t i) { return (i - 1) / 2; }
+static inline size_t child(size_t i)  { return 2 * i + 1; }
+
+// Odd levels are max levels. Level of i is floor(log2(i + 1)).
+static inline bool on_max_level(size_t i) {
+    unsigned level = 0;
+    for (size_t n = i + 1; n > 1; n >>= 1) level++;
+    return level & 1;
+}
+
+// True if a belongs above b on a level of the given kind.
+static inline bool before(const MinMaxHeap *h, const void *a, const void *b, bool max) {
+    int c = h->cmp(a, b);
+    return max ? c > 0 : c < 0;
+}
+
+static inline void swap(void **d, size_t i, size_t j) {
+    void *tmp = d[i];
+    d[i] = d[j];
+    d[j] = tmp;
+}
+
+// --- Heapify helpers ---
+
+// Move element up through grandparents on levels of its own kind.
+static void bubble_up_grand(MinMaxHeap *h, size_t i, bool max) {
+    while (i > 2) {
+        size_t g = parent(parent(i));
+        if (!before(h, h->data[i], h->data[g], max))
+            break;
+        swap(h->data, i, g);
+        i = g;
+    }
+}
+
+static void bubble_up(MinMaxHeap *h, size_t i) {
+    if (i == 0) return;
+    bool max = on_max_level(i);
+    size_t p = parent(i);
+    // Belongs on the other kind of level: hop to the parent first.
+    if (before(h, h->data[i], h->data[p], !max)) {
+        swap(h->data, i, p);
+        bubble_up_grand(h, p, !max);
+    } else {
+        bubble_up_grand(h, i, max);
+    }
+}
+
+// Push element at i down; `max` is the kind of i's level.
+static void trickle_down(MinMaxHeap *h, size_t i, bool max) {
+    for (;;) {
+        size_t c = child(i);
+        if (c >= h->size)
+            return;
+
+        // Best among children and grandchildren.
+        size_t m = c;
+        size_t end = c + 2 < h->size ? c + 2 : h->size;
+        for (size_t k = c; k < end; k++) {
+            if (k != m && before(h, h->data[k], h->data[m], max)) m = k;
+            size_t g = child(k);
+            size_t gend = g + 2 < h->size ? g + 2 : h->size;
+            for (; g < gend; g++)
+                if (before(h, h->data[g], h->data[m], max)) m = g;
+        }
+
+        if (!before(h, h->data[m], h->data[i], max))
+            return;
+        swap(h->data, i, m);
+        if (m < child(c))          // a child: it has no descendants left to fix
+            return;
+        size_t p = parent(m);
+        if (before(h, h->data[p], h->data[m], max))
+            swap(h->data, m, p);
+        i = m;
+    }
+}
+
+// Remove the element at slot i (i < size).
+static void *remove_at(MinMaxHeap *h, size_t i) {
+    void *item = h->data[i];
+    h->size--;
+    if (i < h->size) {
+        h->data[i] = h->data[h->size];
+        trickle_down(h, i, on_max_level(i));
+    }
+    return item;
+}
+
+static inline size_t max_index(const MinMaxHeap *h) {
+    if (h->size <= 2) return h->size - 1;
+    return h->cmp(h->data[2], h->data[1]) > 0 ? 2 : 1;
+}
+
+// -----------------------------------------------------------
+// Public API
+// -----------------------------------------------------------
+
+MinMaxHeap *minmax_heap_create(heap_cmp_fn cmp, size_t capacity) {
+    if (!cmp) return NULL;
+    MinMaxHeap *h = calloc(1, sizeof(*h));
+    if (!h) return NULL;
+    if (capacity == 0) capacity = MINMAX_HEAP_DEFAULT_CAP;
+    h->data = malloc(capacity * sizeof(void *));
+    if (!h->data) { free(h); return NULL; }
+    h->capacity = capacity;
+    h->cmp = cmp;
+    return h;
+}
+
+MinMaxHeap *minmax_heap_build(void **arr, size_t n, heap_cmp_fn cmp) {
+    MinMaxHeap *h = minmax_heap_create(cmp, n);
+    if (!h) return NULL;
+    if (n > 0)
+        memcpy(h->data, arr, n * sizeof(void *));
+    h->size = n;
+    for (size_t i = n / 2; i-- > 0;)
+        trickle_down(h, i, on_max_level(i));
+    return h;
+}
+
+void minmax_heap_destroy(MinMaxHeap *h) {
+    if (!h) return;
+    free(h->data);
+    free(h);
+}
+
+int minmax_heap_reserve(MinMaxHeap *h, size_t n) {
+    if (h->capacity >= n) return 0;
+    void **tmp = realloc(h->data, n * sizeof(void *));
+    if (!tmp) return HEAP_ERR_NOMEM;
+    h->data = tmp;
+    h->capacity = n;
+    return 0;
+}
+
+int minmax_heap_insert(MinMaxHeap *h, void *item) {
+    if (h->size == h->capacity && minmax_heap_reserve(h, h->capacity * 2) < 0)
+        return HEAP_ERR_NOMEM;
+    h->data[h->size] = item;
+    bubble_up(h, h->size);
+    h->size++;
+    return 0;
+}
+
+void *minmax_heap_peek_min(const MinMaxHeap *h) {
+    return (h && h->size > 0) ? h->data[0] : NULL;
+}
+
+void *minmax_heap_peek_max(const MinMaxHeap *h) {
+    return (h && h->size > 0) ? h->data[max_index(h)] : NULL;
+}
+
+void *minmax_heap_extract_min(MinMaxHeap *h) {
+    if (!h || h->size == 0) return NULL;
+    return remove_at(h, 0);
+}
+
+void *minmax_heap_extract_max(MinMaxHeap *h) {
+    if (!h || h->size == 0) return NULL;
+    return remove_at(h, max_index(h));
+}
+
+size_t minmax_heap_size(const MinMaxHeap *h) {
+    return h ? h->size : 0;
+}
+
+void minmax_heap_clear(MinMaxHeap *h) {
+    if (h) h->size = 0;
+}
+
+// Checking each node against its parent and grandparent covers all
+// descendants by transitivity.
+bool minmax_heap_validate(const MinMaxHeap *h) {
+    if (!h) return false;
+    for (size_t i = 1; i < h->size; i++) {
+        bool max = on_max_level(i);
+        size_t p = parent(i);
+        if (before(h, h->data[i], h->data[p], !max))
+            return false;
+        if (i > 2 && before(h, h->data[i], h->data[parent(p)], max))
+            return false;
+    }
+    return true;
+}
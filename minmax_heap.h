@@ -0,0 +1,90 @@
+#ifndef MINMAX_HEAP_H
+#define MINMAX_HEAP_H
+
+#include <stddef.h> // size_t
+#include <stdbool.h>
+#include "heap.h"   // heap_cmp_fn
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct MinMaxHeap MinMaxHeap;
+
+/**
+ * @brief Create a new double-ended heap (min-max heap).
+ *
+ * A single array where even levels are ordered like a min-heap and odd
+ * levels like a max-heap: both the smallest and the largest element are
+ * available in O(1) and removable in O(log n).
+ *
+ * @param cmp Comparator function. Must return positive if a > b.
+ * @param capacity Optional initial capacity (0 for default).
+ * @return Pointer to MinMaxHeap or NULL on failure.
+ */
+MinMaxHeap *minmax_heap_create(heap_cmp_fn cmp, size_t capacity);
+
+/**
+ * @brief Build a min-max heap from an existing array in O(n).
+ *
+ * Copies the array, then trickles down from the last internal node to the
+ * root (Floyd's construction).
+ */
+MinMaxHeap *minmax_heap_build(void **arr, size_t n, heap_cmp_fn cmp);
+
+/**
+ * @brief Free heap memory.
+ */
+void minmax_heap_destroy(MinMaxHeap *h);
+
+/**
+ * @brief Insert new element.
+ * @return 0 on success, HEAP_ERR_NOMEM on allocation failure.
+ */
+int minmax_heap_insert(MinMaxHeap *h, void *item);
+
+/**
+ * @brief Smallest element, or NULL if empty.
+ */
+void *minmax_heap_peek_min(const MinMaxHeap *h);
+
+/**
+ * @brief Largest element, or NULL if empty.
+ */
+void *minmax_heap_peek_max(const MinMaxHeap *h);
+
+/**
+ * @brief Remove and return the smallest element.
+ */
+void *minmax_heap_extract_min(MinMaxHeap *h);
+
+/**
+ * @brief Remove and return the largest element.
+ */
+void *minmax_heap_extract_max(MinMaxHeap *h);
+
+/**
+ * @brief Number of elements in heap.
+ */
+size_t minmax_heap_size(const MinMaxHeap *h);
+
+/**
+ * @brief Ensure heap capacity for at least n elements.
+ */
+int minmax_heap_reserve(MinMaxHeap *h, size_t n);
+
+/**
+ * @brief Clear heap contents (does not free memory).
+ */
+void minmax_heap_clear(MinMaxHeap *h);
+
+/**
+ * @brief Check min-max heap validity (for debugging).
+ * @return true if every node is ordered against all its descendants.
+ */
+bool minmax_heap_validate(const MinMaxHeap *h);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
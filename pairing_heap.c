@@ -0,0 +1,206 @@
+// Meldable heap (pairing heap) for void* elements
+// -----------------------------------------------
+// - Heap-ordered multiway tree, one node per element
+// - Insert, meld and promote link two trees: one comparison, O(1)
+// - Extract: two-pass pairing of the root's children, O(log n) amortized
+// - Nodes are handles; freed nodes are recycled through a free list
+//
+// Trees are stored child/sibling style: `child` is the leftmost child,
+// `next` the right sibling and `prev` the left sibling (or the parent,
+// for a leftmost child), so any node can be cut out in O(1).
+//
+// -----------------------------------------------
+
+#include "pairing_heap.h"
+#include <stdlib.h>
+
+struct PairingNode {
+    void *item;
+    PairingNode *child;   // leftmost child
+    PairingNode *next;    // right sibling (free list link when unused)
+    PairingNode *prev;    // left sibling, or parent if leftmost
+};
+
+struct PairingHeap {
+    PairingNode *root;
+    PairingNode *free_nodes;  // recycled nodes, chained through `next`
+    size_t size;
+    heap_cmp_fn cmp;
+};
+
+// --- Tree helpers ---
+
+// Link two roots: the worse becomes the leftmost child of the better.
+static PairingNode *link(const PairingHeap *h, PairingNode *a, PairingNode *b) {
+    if (h->cmp(b->item, a->item) > 0) {
+        PairingNode *t = a; a = b; b = t;
+    }
+    b->next = a->child;
+    if (a->child) a->child->prev = b;
+    b->prev = a;
+    a->child = b;
+    return a;
+}
+
+// Two-pass pairing of a sibling list: link neighbours left to right,
+// then fold the results right to left. Returns the new root.
+static PairingNode *combine(const PairingHeap *h, PairingNode *first) {
+    PairingNode *pairs = NULL;  // pass 1 results, rightmost first
+    while (first) {
+        PairingNode *a = first, *b = a->next;
+        if (!b) {
+            a->next = pairs;
+            pairs = a;
+            break;
+        }
+        first = b->next;
+        PairingNode *m = link(h, a, b);
+        m->next = pairs;
+        pairs = m;
+    }
+    if (!pairs) return NULL;
+
+    PairingNode *root = pairs;
+    pairs = pairs->next;
+    while (pairs) {
+        PairingNode *n = pairs->next;
+        root = link(h, root, pairs);
+        pairs = n;
+    }
+    root->next = root->prev = NULL;
+    return root;
+}
+
+// Cut a non-root node (with its subtree) out of its sibling list.
+static void detach(PairingNode *node) {
+    if (node->prev->child == node)
+        node->prev->child = node->next;
+    else
+        node->prev->next = node->next;
+    if (node->next) node->next->prev = node->prev;
+    node->next = node->prev = NULL;
+}
+
+// Visit every node of a tree without recursion, handing each to `fn`
+// after its links are no longer needed (rotates children into the
+// sibling chain as it goes).
+static void drain_tree(PairingNode *node, void (*fn)(PairingHeap *, PairingNode *),
+                       PairingHeap *h) {
+    while (node) {
+        if (node->child) {
+            PairingNode *c = node->child;
+            node->child = c->next;
+            c->next = node;
+            node = c;
+        } else {
+            PairingNode *n = node->next;
+            fn(h, node);
+            node = n;
+        }
+    }
+}
+
+static void recycle_node(PairingHeap *h, PairingNode *node) {
+    node->item = NULL;
+    node->next = h->free_nodes;
+    h->free_nodes = node;
+}
+
+static void free_node(PairingHeap *h, PairingNode *node) {
+    (void)h;
+    free(node);
+}
+
+// -----------------------------------------------------------
+// Public API
+// -----------------------------------------------------------
+
+PairingHeap *pairing_heap_create(heap_cmp_fn cmp) {
+    if (!cmp) return NULL;
+    PairingHeap *h = calloc(1, sizeof(*h));
+    if (!h) return NULL;
+    h->cmp = cmp;
+    return h;
+}
+
+void pairing_heap_destroy(PairingHeap *h) {
+    if (!h) return;
+    drain_tree(h->root, free_node, h);
+    while (h->free_nodes) {
+        PairingNode *n = h->free_nodes->next;
+        free(h->free_nodes);
+        h->free_nodes = n;
+    }
+    free(h);
+}
+
+PairingNode *pairing_heap_insert(PairingHeap *h, void *item) {
+    PairingNode *node = h->free_nodes;
+    if (node) {
+        h->free_nodes = node->next;
+    } else {
+        node = malloc(sizeof(*node));
+        if (!node) return NULL;
+    }
+    node->item = item;
+    node->child = node->next = node->prev = NULL;
+    h->root = h->root ? link(h, h->root, node) : node;
+    h->size++;
+    return node;
+}
+
+void *pairing_heap_peek(const PairingHeap *h) {
+    return (h && h->root) ? h->root->item : NULL;
+}
+
+void *pairing_heap_extract(PairingHeap *h) {
+    if (!h || !h->root) return NULL;
+    PairingNode *top = h->root;
+    void *item = top->item;
+    h->root = combine(h, top->child);
+    recycle_node(h, top);
+    h->size--;
+    return item;
+}
+
+int pairing_heap_meld(PairingHeap *dst, PairingHeap *src) {
+    if (!dst || !src || dst == src || dst->cmp != src->cmp) return -1;
+    if (src->root)
+        dst->root = dst->root ? link(dst, dst->root, src->root) : src->root;
+    dst->size += src->size;
+    src->root = NULL;
+    src->size = 0;
+    return 0;
+}
+
+void pairing_heap_promote(PairingHeap *h, PairingNode *node) {
+    if (node == h->root) return;
+    detach(node);
+    h->root = link(h, h->root, node);
+}
+
+void *pairing_heap_remove(PairingHeap *h, PairingNode *node) {
+    if (node == h->root) return pairing_heap_extract(h);
+    void *item = node->item;
+    detach(node);
+    PairingNode *sub = combine(h, node->child);
+    if (sub) h->root = link(h, h->root, sub);
+    recycle_node(h, node);
+    h->size--;
+    return item;
+}
+
+void *pairing_heap_node_item(const PairingNode *node) {
+    return node ? node->item : NULL;
+}
+
+size_t pairing_heap_size(const PairingHeap *h) {
+    return h ? h->size : 0;
+}
+
+void pairing_heap_clear(PairingHeap *h) {
+    if (!h) return;
+    drain_tree(h->root, recycle_node, h);
+    h->root = NULL;
+    h->size = 0;
+}
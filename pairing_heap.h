@@ -0,0 +1,94 @@
+#ifndef PAIRING_HEAP_H
+#define PAIRING_HEAP_H
+
+#include <stddef.h> // size_t
+#include "heap.h"   // heap_cmp_fn
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct PairingHeap PairingHeap;
+
+/**
+ * @brief Stable reference to an element of a PairingHeap.
+ *
+ * Stays valid across melds (it follows its element into the destination
+ * heap) until the element is extracted or removed.
+ */
+typedef struct PairingNode PairingNode;
+
+/**
+ * @brief Create a new meldable heap (pairing heap).
+ *
+ * Insert and meld are O(1); extract is O(log n) amortized. Each element
+ * lives in its own node, so two heaps sharing a comparator can be melded
+ * without copying.
+ *
+ * @param cmp Comparator function. Must return positive if a > b.
+ * @return Pointer to PairingHeap or NULL on failure.
+ */
+PairingHeap *pairing_heap_create(heap_cmp_fn cmp);
+
+/**
+ * @brief Free heap memory (items are not touched).
+ */
+void pairing_heap_destroy(PairingHeap *h);
+
+/**
+ * @brief Insert new element.
+ * @return Handle to the element, or NULL on allocation failure.
+ */
+PairingNode *pairing_heap_insert(PairingHeap *h, void *item);
+
+/**
+ * @brief Get top element without removing it.
+ */
+void *pairing_heap_peek(const PairingHeap *h);
+
+/**
+ * @brief Remove and return top element.
+ */
+void *pairing_heap_extract(PairingHeap *h);
+
+/**
+ * @brief Move every element of src into dst in O(1), leaving src empty.
+ *
+ * Both heaps must use the same comparator. Handles into src stay valid
+ * and now refer to elements of dst.
+ * @return 0 on success, -1 on bad arguments.
+ */
+int pairing_heap_meld(PairingHeap *dst, PairingHeap *src);
+
+/**
+ * @brief Restore order after the priority of a node's item increased.
+ *
+ * (Increased per the comparator, i.e. the item moved towards the top.)
+ * O(1) amortized.
+ */
+void pairing_heap_promote(PairingHeap *h, PairingNode *node);
+
+/**
+ * @brief Remove a node's element from the heap and return it.
+ */
+void *pairing_heap_remove(PairingHeap *h, PairingNode *node);
+
+/**
+ * @brief Look up the item stored in a node.
+ */
+void *pairing_heap_node_item(const PairingNode *node);
+
+/**
+ * @brief Number of elements in heap.
+ */
+size_t pairing_heap_size(const PairingHeap *h);
+
+/**
+ * @brief Remove all elements (node memory is kept for reuse).
+ */
+void pairing_heap_clear(PairingHeap *h);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,188 @@
+// Radix heap: monotone integer priority queue
+// -----------------------------------------------
+// - Bucket 0 holds keys equal to `last` (the last extracted key); bucket
+//   b > 0 holds keys whose highest bit differing from `last` is bit b-1
+// - Insert: one XOR, one count-leading-zeros, one append
+// - Extract: pop from bucket 0; when it is empty, take the lowest
+//   non-empty bucket, make its minimum the new `last` and redistribute
+//   it. Every entry lands in a strictly lower bucket, so each entry moves
+//   at most 64 times over its lifetime
+// - A bitmap of non-empty buckets finds the next bucket in one ctz
+// - Peek never redistributes: with bucket 0 empty it finds the minimum
+//   of the lowest bucket (cached until the next insert or extract), so a
+//   peek does not raise the insert floor
+//
+// Keys below `last` would break the bucket invariant and are rejected.
+//
+// -----------------------------------------------
+
+#include "radix_heap.h"
+#include <stdlib.h>
+
+#define RADIX_HEAP_BUCKETS 65
+#define RADIX_HEAP_MIN_CAP 8
+#define RADIX_HEAP_NO_MIN  SIZE_MAX
+
+typedef struct RadixEntry {
+    uint64_t key;
+    void *payload;
+} RadixEntry;
+
+typedef struct RadixBucket {
+    RadixEntry *data;
+    size_t size;
+    size_t capacity;
+} RadixBucket;
+
+struct RadixHeap {
+    RadixBucket buckets[RADIX_HEAP_BUCKETS];
+    uint64_t nonempty;    // bit b-1 set if bucket b > 0 is non-empty
+    uint64_t last;        // last extracted key
+    size_t size;          // total number of entries
+    size_t min_at;        // first minimum of the lowest bucket, or NO_MIN
+};
+
+// --- Bucket helpers ---
+
+static inline unsigned bucket_of(uint64_t key, uint64_t last) {
+    uint64_t x = key ^ last;
+    return x ? 64 - (unsigned)__builtin_clzll(x) : 0;
+}
+
+static int bucket_reserve(RadixBucket *b, size_t n) {
+    if (b->capacity >= n) return 0;
+    size_t cap = b->capacity ? b->capacity : RADIX_HEAP_MIN_CAP;
+    while (cap < n) cap *= 2;
+    RadixEntry *p = realloc(b->data, cap * sizeof(*p));
+    if (!p) return -1;
+    b->data = p;
+    b->capacity = cap;
+    return 0;
+}
+
+static inline void bucket_push(RadixHeap *h, unsigned b, RadixEntry e) {
+    RadixBucket *bk = &h->buckets[b];
+    bk->data[bk->size++] = e;
+    if (b) h->nonempty |= UINT64_C(1) << (b - 1);
+}
+
+// Lowest non-empty bucket above 0 (bucket 0 must be empty).
+static inline unsigned lowest_bucket(const RadixHeap *h) {
+    return (unsigned)__builtin_ctzll(h->nonempty) + 1;
+}
+
+// Index of the first minimum in bucket b, cached in h->min_at.
+static size_t find_min(RadixHeap *h, unsigned b) {
+    if (h->min_at != RADIX_HEAP_NO_MIN) return h->min_at;
+    const RadixBucket *src = &h->buckets[b];
+    size_t mi = 0;
+    for (size_t i = 1; i < src->size; i++)
+        if (src->data[i].key < src->data[mi].key)
+            mi = i;
+    h->min_at = mi;
+    return mi;
+}
+
+// Make bucket 0 non-empty (heap must not be empty), for extract only:
+// this is where `last` advances. Redistributes the lowest non-empty
+// bucket around its minimum, pushing the entry peek reported last so
+// bucket 0 pops it first; target capacity is reserved up front so a
+// failed allocation leaves the heap untouched.
+static int refill(RadixHeap *h) {
+    if (h->buckets[0].size > 0) return 0;
+
+    unsigned b = lowest_bucket(h);
+    RadixBucket *src = &h->buckets[b];
+    size_t mi = find_min(h, b);
+    uint64_t min = src->data[mi].key;
+
+    size_t count[RADIX_HEAP_BUCKETS] = {0};
+    for (size_t i = 0; i < src->size; i++)
+        count[bucket_of(src->data[i].key, min)]++;
+    for (unsigned t = 0; t < b; t++) {
+        if (count[t] && bucket_reserve(&h->buckets[t], h->buckets[t].size + count[t]) < 0)
+            return -1;
+    }
+
+    h->last = min;
+    h->nonempty &= ~(UINT64_C(1) << (b - 1));
+    for (size_t i = 0; i < src->size; i++)
+        if (i != mi)
+            bucket_push(h, bucket_of(src->data[i].key, min), src->data[i]);
+    bucket_push(h, 0, src->data[mi]);
+    src->size = 0;
+    h->min_at = RADIX_HEAP_NO_MIN;
+    return 0;
+}
+
+// -----------------------------------------------------------
+// Public API
+// -----------------------------------------------------------
+
+RadixHeap *radix_heap_create(void) {
+    RadixHeap *h = calloc(1, sizeof(RadixHeap));
+    if (h) h->min_at = RADIX_HEAP_NO_MIN;
+    return h;
+}
+
+void radix_heap_destroy(RadixHeap *h) {
+    if (!h) return;
+    for (unsigned b = 0; b < RADIX_HEAP_BUCKETS; b++)
+        free(h->buckets[b].data);
+    free(h);
+}
+
+int radix_heap_insert(RadixHeap *h, uint64_t key, void *payload) {
+    if (key < h->last) return RADIX_HEAP_ERR_KEY;
+    unsigned b = bucket_of(key, h->last);
+    RadixBucket *bk = &h->buckets[b];
+    if (bk->size == bk->capacity && bucket_reserve(bk, bk->size + 1) < 0)
+        return -1;
+    bucket_push(h, b, (RadixEntry){ .key = key, .payload = payload });
+    h->size++;
+    h->min_at = RADIX_HEAP_NO_MIN;
+    return 0;
+}
+
+bool radix_heap_peek(RadixHeap *h, uint64_t *key, void **payload) {
+    if (!h || h->size == 0) return false;
+    const RadixEntry *e;
+    RadixBucket *b0 = &h->buckets[0];
+    if (b0->size > 0) {
+        e = &b0->data[b0->size - 1];
+    } else {
+        unsigned b = lowest_bucket(h);
+        e = &h->buckets[b].data[find_min(h, b)];
+    }
+    if (key) *key = e->key;
+    if (payload) *payload = e->payload;
+    return true;
+}
+
+bool radix_heap_extract(RadixHeap *h, uint64_t *key, void **payload) {
+    if (!h || h->size == 0 || refill(h) < 0) return false;
+    RadixBucket *b0 = &h->buckets[0];
+    RadixEntry e = b0->data[--b0->size];
+    if (key) *key = e.key;
+    if (payload) *payload = e.payload;
+    h->size--;
+    return true;
+}
+
+size_t radix_heap_size(const RadixHeap *h) {
+    return h ? h->size : 0;
+}
+
+uint64_t radix_heap_last_key(const RadixHeap *h) {
+    return h ? h->last : 0;
+}
+
+void radix_heap_clear(RadixHeap *h) {
+    if (!h) return;
+    for (unsigned b = 0; b < RADIX_HEAP_BUCKETS; b++)
+        h->buckets[b].size = 0;
+    h->nonempty = 0;
+    h->last = 0;
+    h->size = 0;
+    h->min_at = RADIX_HEAP_NO_MIN;
+}
@@ -0,0 +1,82 @@
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include <stddef.h> // size_t
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Insert rejected: key is below the last extracted key. */
+#define RADIX_HEAP_ERR_KEY (-2)
+
+typedef struct RadixHeap RadixHeap;
+
+/**
+ * @brief Create a monotone min-priority queue of (key, payload) pairs.
+ *
+ * A radix heap buckets entries by the highest bit in which their key
+ * differs from the last extracted key. It needs no comparator and does
+ * O(1) work per insert and O(log U) amortized per extract, but keys must
+ * never go below the last extracted key (timestamps, Dijkstra distances).
+ * 32-bit keys are simply passed widened.
+ *
+ * @return Pointer to RadixHeap or NULL on failure.
+ */
+RadixHeap *radix_heap_create(void);
+
+/**
+ * @brief Free radix heap memory (payloads are not touched).
+ */
+void radix_heap_destroy(RadixHeap *h);
+
+/**
+ * @brief Insert a (key, payload) pair.
+ * @return 0 on success, -1 on allocation failure, RADIX_HEAP_ERR_KEY if
+ *         key < radix_heap_last_key().
+ */
+int radix_heap_insert(RadixHeap *h, uint64_t key, void *payload);
+
+/**
+ * @brief Get the smallest entry without removing it.
+ *
+ * Does not move the insert floor: radix_heap_last_key() stays the last
+ * extracted key, so keys between it and the peeked key may still be
+ * inserted. Not const: the position of the minimum is cached until the
+ * next insert or extract. The next extract returns this same entry.
+ * Either output pointer may be NULL.
+ * @return false if the heap is empty.
+ */
+bool radix_heap_peek(RadixHeap *h, uint64_t *key, void **payload);
+
+/**
+ * @brief Remove the smallest entry and return it through key/payload.
+ *
+ * Entries with equal keys come out in no particular order. Either output
+ * pointer may be NULL.
+ * @return false if the heap is empty or memory for the redistribution
+ *         could not be allocated (the heap is unchanged then).
+ */
+bool radix_heap_extract(RadixHeap *h, uint64_t *key, void **payload);
+
+/**
+ * @brief Number of entries in heap.
+ */
+size_t radix_heap_size(const RadixHeap *h);
+
+/**
+ * @brief Lower bound for future inserts (last extracted key, 0 initially).
+ */
+uint64_t radix_heap_last_key(const RadixHeap *h);
+
+/**
+ * @brief Remove all entries and reset the key floor to 0 (keeps memory).
+ */
+void radix_heap_clear(RadixHeap *h);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,280 @@
+// Hierarchical timing wheel with a heap for due timers
+// -----------------------------------------------
+// - Time is counted in ticks (deadline / tick); `cur` is the last tick
+//   processed by timer_wheel_advance
+// - A timer due after `cur` sits in wheel level l = (highest bit in which
+//   its tick differs from cur) / 6, slot = its l-th 6-bit digit: O(1) add
+//   and O(1) unlink on cancel, no comparisons
+// - Entering a tick whose lower digits are all zero cascades the matching
+//   higher-level slot down; level-0 slot timers are due in that tick and
+//   move into a Heap (with handles, so they stay cancellable) that orders
+//   them by exact deadline
+// - Per-level bitmaps of non-empty slots let advance jump straight to the
+//   next interesting tick, so idle stretches cost nothing
+//
+// Most timers are cancelled long before they are due and never reach
+// the heap, which therefore only holds the current tick's timers.
+//
+// -----------------------------------------------
+
+#include "timer_wheel.h"
+#include "heap.h"
+#include <stdlib.h>
+
+#define WHEEL_BITS      6
+#define WHEEL_SLOTS     (1u << WHEEL_BITS)
+#define WHEEL_LEVELS    4
+#define WHEEL_RANGE_BITS (WHEEL_BITS * WHEEL_LEVELS)
+#define WHEEL_CHUNK     256   // timers allocated per slab
+
+#define WHERE_HEAP      (-1)
+#define WHERE_OVERFLOW  (-2)
+#define WHERE_RETRY     (-3)
+
+struct WheelTimer {
+    uint64_t deadline;
+    void *payload;
+    WheelTimer *next, *prev;  // slot list (next doubles as free list link)
+    int level;                // wheel level or WHERE_*
+    unsigned slot;
+    HeapHandle handle;        // valid while level == WHERE_HEAP
+};
+
+typedef struct TimerSlab {
+    struct TimerSlab *next;
+    WheelTimer timers[WHEEL_CHUNK];
+} TimerSlab;
+
+struct TimerWheel {
+    WheelTimer *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    uint64_t used[WHEEL_LEVELS];  // bit s set if slots[l][s] is non-empty
+    WheelTimer *overflow;         // beyond the wheel's range
+    WheelTimer *retry;            // due, but the heap could not grow
+    Heap *due;                    // timers due in tick `cur`
+    uint64_t cur;                 // last processed tick
+    uint64_t now;                 // latest time seen
+    uint64_t tick;                // time units per tick
+    size_t size;                  // pending timers
+    WheelTimer *free_timers;
+    TimerSlab *slabs;
+};
+
+// Earlier deadline ranks higher (the heap keeps its largest at the root).
+static int deadline_cmp(const void *a, const void *b) {
+    uint64_t x = ((const WheelTimer *)a)->deadline, y = ((const WheelTimer *)b)->deadline;
+    return (x < y) - (x > y);
+}
+
+static inline unsigned digit(uint64_t t, int level) {
+    return (unsigned)(t >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1);
+}
+
+// --- Slot lists ---
+
+static void list_push(WheelTimer **head, WheelTimer *t) {
+    t->prev = NULL;
+    t->next = *head;
+    if (*head) (*head)->prev = t;
+    *head = t;
+}
+
+static void list_unlink(WheelTimer **head, WheelTimer *t) {
+    if (t->prev) t->prev->next = t->next;
+    else *head = t->next;
+    if (t->next) t->next->prev = t->prev;
+}
+
+// File a timer relative to `cur`. The wheel itself never allocates; a
+// due timer the heap has no room for waits on the retry list, which the
+// next advance drains first.
+static void place(TimerWheel *w, WheelTimer *t) {
+    uint64_t tk = t->deadline / w->tick;
+    if (tk <= w->cur) {
+        t->level = WHERE_HEAP;
+        if (heap_insert_handle(w->due, t, &t->handle) < 0) {
+            t->level = WHERE_RETRY;
+            list_push(&w->retry, t);
+        }
+        return;
+    }
+    int level = (63 - __builtin_clzll(tk ^ w->cur)) / WHEEL_BITS;
+    if (level >= WHEEL_LEVELS) {
+        t->level = WHERE_OVERFLOW;
+        list_push(&w->overflow, t);
+        return;
+    }
+    t->level = level;
+    t->slot = digit(tk, level);
+    list_push(&w->slots[level][t->slot], t);
+    w->used[level] |= UINT64_C(1) << t->slot;
+}
+
+// Re-file every timer of a list against the new `cur`.
+static void replace_list(TimerWheel *w, WheelTimer *list) {
+    while (list) {
+        WheelTimer *n = list->next;
+        place(w, list);
+        list = n;
+    }
+}
+
+static void take_slot(TimerWheel *w, int level, unsigned s) {
+    WheelTimer *list = w->slots[level][s];
+    w->slots[level][s] = NULL;
+    w->used[level] &= ~(UINT64_C(1) << s);
+    replace_list(w, list);
+}
+
+// Smallest tick after `cur` at which some pending wheel timer needs work,
+// or UINT64_MAX if the wheel is empty. A slot above `cur`'s digit at a
+// lower level always comes before any slot at a higher level.
+static uint64_t next_tick(const TimerWheel *w) {
+    for (int l = 0; l < WHEEL_LEVELS; l++) {
+        unsigned d = digit(w->cur, l);
+        uint64_t above = d + 1 < WHEEL_SLOTS ? w->used[l] & (~UINT64_C(0) << (d + 1)) : 0;
+        if (above) {
+            unsigned hi = WHEEL_BITS * (l + 1);
+            uint64_t base = hi < 64 ? (w->cur >> hi) << hi : 0;
+            return base | ((uint64_t)__builtin_ctzll(above) << (WHEEL_BITS * l));
+        }
+    }
+    if (w->overflow && (w->cur >> WHEEL_RANGE_BITS) + 1 < (UINT64_C(1) << (64 - WHEEL_RANGE_BITS)))
+        return ((w->cur >> WHEEL_RANGE_BITS) + 1) << WHEEL_RANGE_BITS;
+    return UINT64_MAX;
+}
+
+// Enter tick `cur`: pull in overflow timers at a full wrap, cascade the
+// higher levels whose lower digits just rolled over (top-down), then move
+// the level-0 slot into the heap.
+static void enter_tick(TimerWheel *w) {
+    uint64_t low = w->cur & ((UINT64_C(1) << WHEEL_RANGE_BITS) - 1);
+    if (low == 0 && w->overflow) {
+        WheelTimer *list = w->overflow;
+        w->overflow = NULL;
+        replace_list(w, list);
+    }
+    for (int l = WHEEL_LEVELS - 1; l >= 0; l--) {
+        if (low & ((UINT64_C(1) << (WHEEL_BITS * l)) - 1))
+            continue;
+        unsigned s = digit(w->cur, l);
+        if (w->used[l] & (UINT64_C(1) << s))
+            take_slot(w, l, s);
+    }
+}
+
+// -----------------------------------------------------------
+// Public API
+// -----------------------------------------------------------
+
+TimerWheel *timer_wheel_create(uint64_t now, uint64_t tick) {
+    TimerWheel *w = calloc(1, sizeof(*w));
+    if (!w) return NULL;
+    w->due = heap_create(deadline_cmp, 0);
+    if (!w->due) { free(w); return NULL; }
+    w->tick = tick ? tick : 1;
+    w->now = now;
+    w->cur = now / w->tick;
+    return w;
+}
+
+void timer_wheel_destroy(TimerWheel *w) {
+    if (!w) return;
+    while (w->slabs) {
+        TimerSlab *n = w->slabs->next;
+        free(w->slabs);
+        w->slabs = n;
+    }
+    heap_destroy(w->due);
+    free(w);
+}
+
+WheelTimer *timer_wheel_add(TimerWheel *w, uint64_t deadline, void *payload) {
+    if (!w->free_timers) {
+        TimerSlab *slab = malloc(sizeof(*slab));
+        if (!slab) return NULL;
+        slab->next = w->slabs;
+        w->slabs = slab;
+        for (size_t i = WHEEL_CHUNK; i-- > 0;) {
+            slab->timers[i].next = w->free_timers;
+            w->free_timers = &slab->timers[i];
+        }
+    }
+    WheelTimer *t = w->free_timers;
+    w->free_timers = t->next;
+    t->deadline = deadline;
+    t->payload = payload;
+    place(w, t);
+    w->size++;
+    return t;
+}
+
+void *timer_wheel_cancel(TimerWheel *w, WheelTimer *t) {
+    if (t->level == WHERE_HEAP)
+        (void)heap_remove(w->due, t->handle);
+    else if (t->level == WHERE_OVERFLOW)
+        list_unlink(&w->overflow, t);
+    else if (t->level == WHERE_RETRY)
+        list_unlink(&w->retry, t);
+    else {
+        list_unlink(&w->slots[t->level][t->slot], t);
+        if (!w->slots[t->level][t->slot])
+            w->used[t->level] &= ~(UINT64_C(1) << t->slot);
+    }
+    void *payload = t->payload;
+    t->next = w->free_timers;
+    w->free_timers = t;
+    w->size--;
+    return payload;
+}
+
+size_t timer_wheel_advance(TimerWheel *w, uint64_t now, void **out, size_t max) {
+    if (now > w->now) w->now = now;
+    uint64_t target = w->now / w->tick;
+    if (w->retry) {
+        WheelTimer *list = w->retry;
+        w->retry = NULL;
+        replace_list(w, list);
+    }
+    while (w->cur < target) {
+        uint64_t next = next_tick(w);
+        if (next > target) {
+            w->cur = target;
+            break;
+        }
+        w->cur = next;
+        enter_tick(w);
+    }
+
+    size_t n = 0;
+    while (n < max) {
+        WheelTimer *t = heap_peek(w->due);
+        if (!t || t->deadline > w->now)
+            break;
+        (void)heap_extract(w->due);
+        out[n++] = t->payload;
+        t->next = w->free_timers;
+        w->free_timers = t;
+        w->size--;
+    }
+    return n;
+}
+
+bool timer_wheel_next_expiry(const TimerWheel *w, uint64_t *when) {
+    if (!w || w->size == 0) return false;
+    const WheelTimer *t = heap_peek(w->due);
+    uint64_t at;
+    if (t) {
+        at = t->deadline;
+    } else if (w->retry) {
+        at = w->now;
+    } else {
+        uint64_t tk = next_tick(w);
+        at = tk > UINT64_MAX / w->tick ? UINT64_MAX : tk * w->tick;
+    }
+    if (when) *when = at;
+    return true;
+}
+
+size_t timer_wheel_size(const TimerWheel *w) {
+    return w ? w->size : 0;
+}
@@ -0,0 +1,83 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stddef.h> // size_t
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TimerWheel TimerWheel;
+
+/**
+ * @brief Handle to a pending timer.
+ *
+ * Valid from timer_wheel_add() until the timer is cancelled or returned
+ * by timer_wheel_advance(); using it afterwards is undefined.
+ */
+typedef struct WheelTimer WheelTimer;
+
+/**
+ * @brief Create a timer queue: hierarchical timing wheel plus a small heap.
+ *
+ * Time is in caller units (e.g. ns or ms) and only moves forward. The
+ * wheel has 4 levels of 64 slots (2^24 ticks of range, further timers
+ * wait in an overflow list). A timer costs O(1) to add or cancel while it
+ * sits in the wheel; only timers due in the current tick are moved into
+ * a heap, which yields them in exact deadline order.
+ *
+ * @param now Current time.
+ * @param tick Time units per wheel slot (0 for 1). Coarser ticks make
+ *             advancing cheaper; ordering stays exact either way.
+ * @return Pointer to TimerWheel or NULL on failure.
+ */
+TimerWheel *timer_wheel_create(uint64_t now, uint64_t tick);
+
+/**
+ * @brief Free the timer queue and all pending timers (payloads are not touched).
+ */
+void timer_wheel_destroy(TimerWheel *w);
+
+/**
+ * @brief Schedule a payload to expire at `deadline`.
+ *
+ * Deadlines already in the past expire on the next timer_wheel_advance().
+ * @return Handle for timer_wheel_cancel(), or NULL on allocation failure.
+ */
+WheelTimer *timer_wheel_add(TimerWheel *w, uint64_t deadline, void *payload);
+
+/**
+ * @brief Cancel a pending timer and return its payload.
+ */
+void *timer_wheel_cancel(TimerWheel *w, WheelTimer *t);
+
+/**
+ * @brief Advance time to `now` and collect expired timers.
+ *
+ * Writes up to max payloads of timers with deadline <= now into out[],
+ * earliest deadline first. If more timers have expired, they are returned
+ * by the next call (with the same or a later now).
+ * @return Number of payloads written.
+ */
+size_t timer_wheel_advance(TimerWheel *w, uint64_t now, void **out, size_t max);
+
+/**
+ * @brief Earliest time at which a timer may expire, for choosing a sleep.
+ *
+ * Exact when a timer is due within the current tick, otherwise the start
+ * of the next non-empty wheel slot (a lower bound).
+ * @return false if no timers are pending.
+ */
+bool timer_wheel_next_expiry(const TimerWheel *w, uint64_t *when);
+
+/**
+ * @brief Number of pending timers.
+ */
+size_t timer_wheel_size(const TimerWheel *w);
+
+#ifdef __cplusplus
+}
+#endif
+#endif